@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "backlog-tracker.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+/**
+ * @brief Reset the tracker to hold no classes.
+ */
+void
+BacklogTracker::Clear()
+{
+    m_length.clear();
+    m_priority.clear();
+    m_next.clear();
+    m_prev.clear();
+    m_lengthHead.assign(1, -1);
+    m_maxLength = 0;
+    m_total = 0;
+    m_backlogged.clear();
+}
+
+/**
+ * @brief Append an empty class with the given priority level.
+ *
+ * @param priority Priority level of the class.
+ */
+void
+BacklogTracker::AddClass(uint32_t priority)
+{
+    m_length.push_back(0);
+    m_priority.push_back(priority);
+    m_next.push_back(-1);
+    m_prev.push_back(-1);
+}
+
+/**
+ * @brief Move a class up to the list of the next length.
+ *
+ * @param index Index of the class.
+ */
+void
+BacklogTracker::Increment(uint32_t index)
+{
+    if (m_length[index] == 0)
+    {
+        m_backlogged.insert({m_priority[index], index});
+    }
+    else
+    {
+        Unlink(index);
+    }
+
+    m_length[index]++;
+    m_total++;
+    Link(index);
+    m_maxLength = std::max(m_maxLength, m_length[index]);
+}
+
+/**
+ * @brief Move a class down to the list of the previous length.
+ *
+ * @param index Index of the class.
+ */
+void
+BacklogTracker::Decrement(uint32_t index)
+{
+    uint32_t length = m_length[index];
+    Unlink(index);
+    m_length[index]--;
+    m_total--;
+
+    if (m_length[index] == 0)
+    {
+        m_backlogged.erase({m_priority[index], index});
+    }
+    else
+    {
+        Link(index);
+    }
+
+    // This class now sits one below the old maximum, so the new maximum is at most one lower
+    if (length == m_maxLength && m_lengthHead[length] == -1)
+    {
+        m_maxLength--;
+    }
+}
+
+/**
+ * @brief Returns the backlog of a class
+ */
+uint32_t
+BacklogTracker::GetLength(uint32_t index) const
+{
+    return m_length[index];
+}
+
+/**
+ * @brief Returns the backlog summed over all classes
+ */
+uint32_t
+BacklogTracker::GetTotal() const
+{
+    return m_total;
+}
+
+/**
+ * @brief Returns the head of the list holding the longest classes, or -1 if all are empty
+ */
+int32_t
+BacklogTracker::GetLongest() const
+{
+    return m_maxLength == 0 ? -1 : m_lengthHead[m_maxLength];
+}
+
+/**
+ * @brief Returns the backlogged class with the lowest priority level, or -1 if all are empty
+ */
+int32_t
+BacklogTracker::GetLowestPriority() const
+{
+    return m_backlogged.empty() ? -1 : m_backlogged.begin()->second;
+}
+
+void
+BacklogTracker::Link(uint32_t index)
+{
+    uint32_t length = m_length[index];
+    if (length >= m_lengthHead.size())
+    {
+        m_lengthHead.resize(length + 1, -1);
+    }
+
+    int32_t head = m_lengthHead[length];
+    m_prev[index] = -1;
+    m_next[index] = head;
+    if (head != -1)
+    {
+        m_prev[head] = index;
+    }
+    m_lengthHead[length] = index;
+}
+
+void
+BacklogTracker::Unlink(uint32_t index)
+{
+    if (m_prev[index] != -1)
+    {
+        m_next[m_prev[index]] = m_next[index];
+    }
+    else
+    {
+        m_lengthHead[m_length[index]] = m_next[index];
+    }
+
+    if (m_next[index] != -1)
+    {
+        m_prev[m_next[index]] = m_prev[index];
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef BACKLOG_TRACKER_H
+#define BACKLOG_TRACKER_H
+
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Tracks the backlog of every traffic class to pick push-out victims quickly.
+ *
+ * Classes are kept in one intrusive list per queue length. Since a length only ever changes
+ * by one packet, the longest class is found and maintained in O(1). Backlogged classes are
+ * also kept ordered by priority level, which costs O(log n) only when a class becomes empty or
+ * non-empty.
+ */
+class BacklogTracker
+{
+  public:
+    /**
+     * @brief Forget all classes.
+     */
+    void Clear();
+
+    /**
+     * @brief Register the next class; classes are indexed in the order they are added.
+     *
+     * @param priority Priority level of the class (higher number indicates higher priority).
+     */
+    void AddClass(uint32_t priority);
+
+    /**
+     * @brief Account for one packet added to a class.
+     *
+     * @param index Index of the class.
+     */
+    void Increment(uint32_t index);
+
+    /**
+     * @brief Account for one packet removed from a class.
+     *
+     * @param index Index of the class.
+     */
+    void Decrement(uint32_t index);
+
+    /**
+     * @brief Get the number of packets held by a class.
+     *
+     * @param index Index of the class.
+     * @return The backlog in packets.
+     */
+    uint32_t GetLength(uint32_t index) const;
+
+    /**
+     * @brief Get the number of packets held by all classes.
+     *
+     * @return The total backlog in packets.
+     */
+    uint32_t GetTotal() const;
+
+    /**
+     * @brief Find a class with the largest backlog.
+     *
+     * @return Index of the class, or -1 if all classes are empty.
+     */
+    int32_t GetLongest() const;
+
+    /**
+     * @brief Find a backlogged class with the lowest priority level.
+     *
+     * @return Index of the class, or -1 if all classes are empty.
+     */
+    int32_t GetLowestPriority() const;
+
+  private:
+    /**
+     * @brief Insert a class into the list of its current length.
+     *
+     * @param index Index of the class.
+     */
+    void Link(uint32_t index);
+
+    /**
+     * @brief Remove a class from the list of its current length.
+     *
+     * @param index Index of the class.
+     */
+    void Unlink(uint32_t index);
+
+    std::vector<uint32_t> m_length;     //!< Backlog of each class
+    std::vector<uint32_t> m_priority;   //!< Priority level of each class
+    std::vector<int32_t> m_next;        //!< Next class with the same length, or -1
+    std::vector<int32_t> m_prev;        //!< Previous class with the same length, or -1
+    std::vector<int32_t> m_lengthHead;  //!< First class of each length, or -1
+    uint32_t m_maxLength{0};            //!< Largest backlog of any class
+    uint32_t m_total{0};                //!< Sum of all backlogs
+    std::set<std::pair<uint32_t, uint32_t>> m_backlogged; //!< (priority, index) of busy classes
+};
+
+} // namespace ns3
+
+#endif // BACKLOG_TRACKER_H
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "bucket-queue.h"
+
+namespace ns3
+{
+
+BucketQueue::BucketQueue()
+{
+    Reset(0);
+}
+
+void
+BucketQueue::Reset(uint32_t classes)
+{
+    m_nonEmpty.Reset();
+    m_bucketHead.fill(-1);
+    m_bucketTail.fill(-1);
+    m_next.assign(classes, -1);
+    m_prev.assign(classes, -1);
+    m_rank.assign(classes, -1);
+    m_size = 0;
+}
+
+void
+BucketQueue::Push(uint32_t index, uint32_t rank)
+{
+    Remove(index);
+
+    m_rank[index] = rank;
+    m_next[index] = -1;
+    m_prev[index] = m_bucketTail[rank];
+    if (m_bucketTail[rank] >= 0)
+    {
+        m_next[m_bucketTail[rank]] = index;
+    }
+    else
+    {
+        m_bucketHead[rank] = index;
+        m_nonEmpty.Set(rank);
+    }
+    m_bucketTail[rank] = index;
+    m_size++;
+}
+
+void
+BucketQueue::Remove(uint32_t index)
+{
+    int32_t rank = m_rank[index];
+    if (rank < 0)
+    {
+        return;
+    }
+
+    int32_t prev = m_prev[index];
+    int32_t next = m_next[index];
+    if (prev >= 0)
+    {
+        m_next[prev] = next;
+    }
+    else
+    {
+        m_bucketHead[rank] = next;
+    }
+    if (next >= 0)
+    {
+        m_prev[next] = prev;
+    }
+    else
+    {
+        m_bucketTail[rank] = prev;
+    }
+    if (m_bucketHead[rank] < 0)
+    {
+        m_nonEmpty.Clear(rank);
+    }
+
+    m_rank[index] = -1;
+    m_size--;
+}
+
+bool
+BucketQueue::Contains(uint32_t index) const
+{
+    return m_rank[index] >= 0;
+}
+
+int32_t
+BucketQueue::Top() const
+{
+    int32_t rank = m_nonEmpty.FindFirst();
+    return rank < 0 ? -1 : m_bucketHead[rank];
+}
+
+uint32_t
+BucketQueue::GetSize() const
+{
+    return m_size;
+}
+
+} // namespace ns3
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include "priority-bitmap.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Priority queue of traffic class indices for small integer ranks.
+ *
+ * There is one FIFO bucket per rank below PriorityBitmap::MAX_SLOTS, and a PriorityBitmap
+ * marks the non-empty buckets, so the lowest rank is found with find-first-set in constant
+ * time. Equal ranks leave in insertion order. Every operation is O(1).
+ */
+class BucketQueue
+{
+  public:
+    static constexpr uint32_t MAX_RANK = PriorityBitmap::MAX_SLOTS - 1; //!< Largest rank
+
+    BucketQueue();
+
+    /**
+     * @brief Empty the queue and size it for a number of classes.
+     *
+     * @param classes Number of class indices the queue may hold.
+     */
+    void Reset(uint32_t classes);
+
+    /**
+     * @brief Append a class to the bucket of a rank, moving it if it is already queued.
+     *
+     * @param index The class index.
+     * @param rank The rank, at most MAX_RANK.
+     */
+    void Push(uint32_t index, uint32_t rank);
+
+    /**
+     * @brief Remove a class if it is queued.
+     *
+     * @param index The class index.
+     */
+    void Remove(uint32_t index);
+
+    /**
+     * @brief Check whether a class is queued.
+     *
+     * @param index The class index.
+     * @return true if the class is queued.
+     */
+    bool Contains(uint32_t index) const;
+
+    /**
+     * @brief Get the first class of the lowest non-empty bucket.
+     *
+     * @return The class index, or -1 if the queue is empty.
+     */
+    int32_t Top() const;
+
+    /**
+     * @brief Get the number of queued classes.
+     *
+     * @return The size.
+     */
+    uint32_t GetSize() const;
+
+  private:
+    PriorityBitmap m_nonEmpty;                      //!< Bit r is set while bucket r has classes
+    std::array<int32_t, MAX_RANK + 1> m_bucketHead; //!< First class of each bucket, or -1
+    std::array<int32_t, MAX_RANK + 1> m_bucketTail; //!< Last class of each bucket, or -1
+    std::vector<int32_t> m_next;                    //!< Next class in the same bucket, or -1
+    std::vector<int32_t> m_prev;                    //!< Previous class in the same bucket, or -1
+    std::vector<int32_t> m_rank;                    //!< Bucket of each class, -1 if not queued
+    uint32_t m_size;                                //!< Number of queued classes
+};
+
+} // namespace ns3
+
+#endif // BUCKET_QUEUE_H
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "calendar-queue.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+CalendarQueue::CalendarQueue()
+{
+    Reset(0, 1);
+}
+
+void
+CalendarQueue::Reset(uint32_t classes, double slotWidth)
+{
+    m_slotWidth = slotWidth;
+    m_base = 0;
+    m_nonEmpty.Reset();
+    m_bucketHead.fill(-1);
+    m_bucketTail.fill(-1);
+    m_next.assign(classes, -1);
+    m_prev.assign(classes, -1);
+    m_buckets.assign(classes, -1);
+    m_keys.assign(classes, 0);
+    m_wheelSize = 0;
+    m_overflow.Reset(classes);
+}
+
+/**
+ * @brief The wheel always starts at the slot of the smallest key, so an empty wheel is simply
+ *        restarted at the new key. A key below the start goes into the first bucket, where the
+ *        sorted order still puts it ahead of everything else.
+ */
+void
+CalendarQueue::Push(uint32_t index, double key)
+{
+    Remove(index);
+
+    m_keys[index] = key;
+    uint64_t slot = GetSlot(key);
+    if (m_wheelSize == 0)
+    {
+        m_base = slot; // the heap is empty too
+    }
+    else if (slot < m_base)
+    {
+        slot = m_base;
+    }
+
+    if (slot - m_base >= SLOTS)
+    {
+        m_overflow.Push(index, key);
+        return;
+    }
+    Insert(index, slot % SLOTS);
+}
+
+void
+CalendarQueue::Remove(uint32_t index)
+{
+    int32_t bucket = m_buckets[index];
+    if (bucket < 0)
+    {
+        m_overflow.Remove(index);
+        return;
+    }
+
+    int32_t prev = m_prev[index];
+    int32_t next = m_next[index];
+    if (prev >= 0)
+    {
+        m_next[prev] = next;
+    }
+    else
+    {
+        m_bucketHead[bucket] = next;
+    }
+    if (next >= 0)
+    {
+        m_prev[next] = prev;
+    }
+    else
+    {
+        m_bucketTail[bucket] = prev;
+    }
+    m_buckets[index] = -1;
+    m_wheelSize--;
+
+    if (m_bucketHead[bucket] < 0)
+    {
+        m_nonEmpty.Clear(bucket);
+        if (static_cast<uint32_t>(bucket) == m_base % SLOTS)
+        {
+            Advance();
+        }
+    }
+}
+
+bool
+CalendarQueue::Contains(uint32_t index) const
+{
+    return m_buckets[index] >= 0 || m_overflow.Contains(index);
+}
+
+/**
+ * @brief The first bucket holds the smallest key whenever the wheel is not empty, and the heap
+ *        is only used while it is not.
+ */
+int32_t
+CalendarQueue::Top() const
+{
+    return m_wheelSize == 0 ? -1 : m_bucketHead[m_base % SLOTS];
+}
+
+double
+CalendarQueue::TopKey() const
+{
+    return m_keys[Top()];
+}
+
+double
+CalendarQueue::GetKey(uint32_t index) const
+{
+    return m_keys[index];
+}
+
+uint32_t
+CalendarQueue::GetSize() const
+{
+    return m_wheelSize + m_overflow.GetSize();
+}
+
+uint64_t
+CalendarQueue::GetSlot(double key) const
+{
+    static constexpr uint64_t MAX_SLOT = uint64_t(1) << 62; // far beyond any wheel position
+
+    if (!(key > 0))
+    {
+        return 0;
+    }
+    double slot = std::floor(key / m_slotWidth);
+    return slot < MAX_SLOT ? static_cast<uint64_t>(slot) : MAX_SLOT;
+}
+
+/**
+ * @brief Equal keys keep their insertion order. Buckets hold few classes and keys mostly grow,
+ *        so the walk from the tail is short.
+ */
+void
+CalendarQueue::Insert(uint32_t index, uint32_t bucket)
+{
+    int32_t prev = m_bucketTail[bucket];
+    while (prev >= 0 && m_keys[prev] > m_keys[index])
+    {
+        prev = m_prev[prev];
+    }
+
+    int32_t next = prev >= 0 ? m_next[prev] : m_bucketHead[bucket];
+    m_prev[index] = prev;
+    m_next[index] = next;
+    if (prev >= 0)
+    {
+        m_next[prev] = index;
+    }
+    else
+    {
+        m_bucketHead[bucket] = index;
+    }
+    if (next >= 0)
+    {
+        m_prev[next] = index;
+    }
+    else
+    {
+        m_bucketTail[bucket] = index;
+    }
+
+    m_buckets[index] = bucket;
+    m_nonEmpty.Set(bucket);
+    m_wheelSize++;
+}
+
+/**
+ * @brief The buckets after the first one are searched in wheel order, wrapping around the
+ *        bitmap. Heap entries only ever move forward onto the wheel, each of them once.
+ */
+void
+CalendarQueue::Advance()
+{
+    if (m_wheelSize > 0)
+    {
+        uint32_t first = m_base % SLOTS;
+        int32_t bucket = m_nonEmpty.FindNext(first);
+        if (bucket < 0)
+        {
+            bucket = m_nonEmpty.FindFirst();
+        }
+        m_base += (bucket + SLOTS - first) % SLOTS;
+    }
+    else if (m_overflow.GetSize() > 0)
+    {
+        m_base = GetSlot(m_overflow.TopKey());
+    }
+
+    while (m_overflow.GetSize() > 0)
+    {
+        uint64_t slot = GetSlot(m_overflow.TopKey());
+        if (slot - m_base >= SLOTS)
+        {
+            break;
+        }
+        uint32_t index = m_overflow.Top();
+        m_overflow.Remove(index);
+        Insert(index, slot % SLOTS);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef CALENDAR_QUEUE_H
+#define CALENDAR_QUEUE_H
+
+#include "indexed-heap.h"
+#include "priority-bitmap.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Calendar queue of traffic class indices keyed by a timestamp.
+ *
+ * Keys are split into slots of a fixed width, and a wheel of PriorityBitmap::MAX_SLOTS buckets
+ * covers the slots from the one holding the smallest key onwards; each bucket is kept sorted,
+ * so the order is exact, not rounded to the slot width. With a slot width close to the usual
+ * spacing of the keys a bucket holds about one class, and inserting, removing and finding the
+ * minimum are O(1). When the minimum leaves, the wheel advances to the next non-empty bucket
+ * with find-first-set. Keys beyond the wheel wait in a heap and move onto the wheel once it
+ * reaches them, so only they cost O(log n). Keys below the current minimum are accepted and
+ * simply sort first in the lowest bucket.
+ */
+class CalendarQueue
+{
+  public:
+    static constexpr uint32_t SLOTS = PriorityBitmap::MAX_SLOTS; //!< Buckets on the wheel
+
+    CalendarQueue();
+
+    /**
+     * @brief Empty the queue and size it for a number of classes.
+     *
+     * @param classes Number of class indices the queue may hold.
+     * @param slotWidth Range of keys sharing a bucket, in the unit of the keys.
+     */
+    void Reset(uint32_t classes, double slotWidth);
+
+    /**
+     * @brief Insert a class, or change its key if it is already queued.
+     *
+     * @param index The class index.
+     * @param key The key to order it by, not negative.
+     */
+    void Push(uint32_t index, double key);
+
+    /**
+     * @brief Remove a class if it is queued.
+     *
+     * @param index The class index.
+     */
+    void Remove(uint32_t index);
+
+    /**
+     * @brief Check whether a class is queued.
+     *
+     * @param index The class index.
+     * @return true if the class is queued.
+     */
+    bool Contains(uint32_t index) const;
+
+    /**
+     * @brief Get the class with the smallest key; equal keys leave in insertion order.
+     *
+     * @return The class index, or -1 if the queue is empty.
+     */
+    int32_t Top() const;
+
+    /**
+     * @brief Get the smallest key.
+     *
+     * @return The key of Top(); only meaningful if the queue is not empty.
+     */
+    double TopKey() const;
+
+    /**
+     * @brief Get the key of a queued class.
+     *
+     * @param index The class index, which must be queued.
+     * @return Its key.
+     */
+    double GetKey(uint32_t index) const;
+
+    /**
+     * @brief Get the number of queued classes.
+     *
+     * @return The size.
+     */
+    uint32_t GetSize() const;
+
+  private:
+    /**
+     * @brief Get the slot a key falls into, saturating for huge or infinite keys.
+     */
+    uint64_t GetSlot(double key) const;
+
+    /**
+     * @brief Link a class into a wheel bucket behind every class with a key not above its own.
+     */
+    void Insert(uint32_t index, uint32_t bucket);
+
+    /**
+     * @brief Move the start of the wheel to the lowest non-empty bucket, and pull the heap
+     *        entries the wheel now covers onto it.
+     */
+    void Advance();
+
+    double m_slotWidth;                      //!< Range of keys per slot
+    uint64_t m_base;                         //!< Slot of the first bucket on the wheel
+    PriorityBitmap m_nonEmpty;               //!< Bit b is set while bucket b has classes
+    std::array<int32_t, SLOTS> m_bucketHead; //!< First class of each bucket, or -1
+    std::array<int32_t, SLOTS> m_bucketTail; //!< Last class of each bucket, or -1
+    std::vector<int32_t> m_next;             //!< Next class in the same bucket, or -1
+    std::vector<int32_t> m_prev;             //!< Previous class in the same bucket, or -1
+    std::vector<int32_t> m_buckets;          //!< Bucket of each class, -1 if not on the wheel
+    std::vector<double> m_keys;              //!< Key of each class
+    uint32_t m_wheelSize;                    //!< Number of classes on the wheel
+    IndexedHeap m_overflow;                  //!< Classes with keys beyond the wheel
+};
+
+} // namespace ns3
+
+#endif // CALENDAR_QUEUE_H
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "diff-serv-queue-disc.h"
+
+#include "qos-initializer.h"
+
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE("DiffServQueueDisc");
+
+namespace ns3
+{
+
+/** Reason given to QueueDisc::Mark for a CE mark set inside the scheduler */
+static const char* const SCHEDULER_MARK = "CE mark set by the scheduler";
+
+NS_OBJECT_ENSURE_REGISTERED(DiffServItemQueue);
+NS_OBJECT_ENSURE_REGISTERED(DiffServQueueDisc);
+
+// TypeId registration with ns-3
+TypeId
+DiffServItemQueue::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::DiffServItemQueue")
+                            .SetParent<Queue<QueueDiscItem>>()
+                            .SetGroupName("TrafficControl")
+                            .AddConstructor<DiffServItemQueue>();
+    return tid;
+}
+
+DiffServItemQueue::DiffServItemQueue()
+{
+    SetMaxSize(QueueSize(QueueSizeUnit::PACKETS, std::numeric_limits<uint32_t>::max()));
+}
+
+/**
+ * @brief Drops inside the scheduler show up on its DropAfterDequeue trace source, whether its
+ *        own classes or their child schedulers made them.
+ *
+ * @param scheduler The scheduler.
+ */
+void
+DiffServItemQueue::SetScheduler(Ptr<DiffServ> scheduler)
+{
+    m_scheduler = scheduler;
+    m_scheduler->TraceConnectWithoutContext(
+        "DropAfterDequeue",
+        MakeCallback(&DiffServItemQueue::NotifySchedulerDrop, this));
+}
+
+Ptr<DiffServ>
+DiffServItemQueue::GetScheduler() const
+{
+    return m_scheduler;
+}
+
+void
+DiffServItemQueue::SetMarkCallback(Callback<bool, Ptr<QueueDiscItem>> cb)
+{
+    m_markCallback = cb;
+}
+
+/**
+ * @brief The filters read the IPv4 header kept by the item, which keeps it until the device
+ *        sends the item and adds it. The scheduler is given a copy of the packet with that
+ *        header in front instead: its sizes are then those on the wire without the link layer,
+ *        and child schedulers, flow hashing and ECN marking find the header where they look for
+ *        it. The copy shares the packet's buffer until the scheduler marks it.
+ *
+ * @param item The item to enqueue.
+ * @return true if the item was admitted.
+ */
+bool
+DiffServItemQueue::Enqueue(Ptr<QueueDiscItem> item)
+{
+    int32_t index = m_scheduler->GetDefaultClass();
+    Ptr<Packet> p = item->GetPacket()->Copy();
+    Ptr<Ipv4QueueDiscItem> ipv4Item = DynamicCast<Ipv4QueueDiscItem>(item);
+    if (ipv4Item)
+    {
+        index = m_scheduler->ClassifyHeader(ipv4Item->GetHeader(), item->GetPacket());
+        p->AddHeader(ipv4Item->GetHeader());
+    }
+    if (index < 0)
+    {
+        DropBeforeEnqueue(item);
+        return false;
+    }
+
+    if (!m_scheduler->EnqueueToClass(index, p))
+    {
+        DropBeforeEnqueue(item);
+        return false;
+    }
+
+    // Cannot fail, the container has no limit of its own
+    Iterator position;
+    DoEnqueue(end(), item, position);
+    m_positions[PeekPointer(p)] = position;
+    return true;
+}
+
+/**
+ * @brief Dequeue from the scheduler, and the item of the packet it returns from the container.
+ *        A CE mark the scheduler set on its copy is carried over to the item.
+ *
+ * @return The item, or nullptr if nothing can be sent.
+ */
+Ptr<QueueDiscItem>
+DiffServItemQueue::Dequeue()
+{
+    Ptr<Packet> p = m_scheduler->Dequeue();
+    if (!p)
+    {
+        return nullptr;
+    }
+    Ptr<QueueDiscItem> item = DoDequeue(TakePosition(p));
+    TransferMark(p, item);
+    return item;
+}
+
+/**
+ * @brief Dequeue from the scheduler and count the item as dropped.
+ *
+ * @return The item, or nullptr if nothing can be sent.
+ */
+Ptr<QueueDiscItem>
+DiffServItemQueue::Remove()
+{
+    Ptr<Packet> p = m_scheduler->Dequeue();
+    if (!p)
+    {
+        return nullptr;
+    }
+    return DoRemove(TakePosition(p));
+}
+
+/**
+ * @brief The scheduler caches the decision behind Peek, so the following Dequeue is cheap.
+ *
+ * @return The item Dequeue would return, or nullptr if nothing can be sent.
+ */
+Ptr<const QueueDiscItem>
+DiffServItemQueue::Peek() const
+{
+    Ptr<const Packet> p = m_scheduler->Peek();
+    if (!p)
+    {
+        return nullptr;
+    }
+    auto it = m_positions.find(PeekPointer(p));
+    if (it == m_positions.end())
+    {
+        return nullptr;
+    }
+    return DoPeek(it->second);
+}
+
+DiffServItemQueue::ConstIterator
+DiffServItemQueue::TakePosition(Ptr<const Packet> p)
+{
+    auto it = m_positions.find(PeekPointer(p));
+    NS_ASSERT_MSG(it != m_positions.end(), "Packet left the scheduler without an item");
+    ConstIterator position = it->second;
+    m_positions.erase(it);
+    return position;
+}
+
+/**
+ * @brief The item leaves the container through DoRemove, which fires the Dequeue and
+ *        DropAfterDequeue trace sources the queue disc counts the drop with.
+ *
+ * @param p The dropped packet.
+ */
+void
+DiffServItemQueue::NotifySchedulerDrop(Ptr<const Packet> p)
+{
+    auto it = m_positions.find(PeekPointer(p));
+    if (it == m_positions.end())
+    {
+        return;
+    }
+    ConstIterator position = it->second;
+    m_positions.erase(it);
+    DoRemove(position);
+}
+
+/**
+ * @brief Only an IPv4 item whose own header is not marked yet is marked, through the mark
+ *        callback so that the queue disc counts it.
+ *
+ * @param p The packet the scheduler returned.
+ * @param item The item of the packet.
+ */
+void
+DiffServItemQueue::TransferMark(Ptr<const Packet> p, Ptr<QueueDiscItem> item)
+{
+    Ptr<Ipv4QueueDiscItem> ipv4Item = DynamicCast<Ipv4QueueDiscItem>(item);
+    if (!ipv4Item || ipv4Item->GetHeader().GetEcn() == Ipv4Header::ECN_CE)
+    {
+        return;
+    }
+
+    Ipv4Header header;
+    p->PeekHeader(header);
+    if (header.GetEcn() == Ipv4Header::ECN_CE && !m_markCallback.IsNull())
+    {
+        m_markCallback(item);
+    }
+}
+
+void
+DiffServItemQueue::DoDispose()
+{
+    if (m_scheduler)
+    {
+        m_scheduler->Dispose();
+        m_scheduler = nullptr;
+    }
+    m_positions.clear();
+    m_markCallback.Nullify();
+    Queue<QueueDiscItem>::DoDispose();
+}
+
+// TypeId registration with ns-3
+TypeId
+DiffServQueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::DiffServQueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<DiffServQueueDisc>()
+            .AddAttribute("Config",
+                          "Path to the JSON configuration file; its type selects the scheduler",
+                          StringValue(""),
+                          MakeStringAccessor(&DiffServQueueDisc::m_configFile),
+                          MakeStringChecker());
+    return tid;
+}
+
+DiffServQueueDisc::DiffServQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::NO_LIMITS)
+{
+}
+
+Ptr<DiffServ>
+DiffServQueueDisc::GetScheduler() const
+{
+    return m_queue ? m_queue->GetScheduler() : nullptr;
+}
+
+/**
+ * @brief Release the internal queue, which disposes of the scheduler.
+ */
+void
+DiffServQueueDisc::DoDispose()
+{
+    if (m_queue)
+    {
+        m_queue->Dispose();
+        m_queue = nullptr;
+    }
+    QueueDisc::DoDispose();
+}
+
+bool
+DiffServQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    return m_queue->Enqueue(item);
+}
+
+Ptr<QueueDiscItem>
+DiffServQueueDisc::DoDequeue()
+{
+    return m_queue->Dequeue();
+}
+
+Ptr<const QueueDiscItem>
+DiffServQueueDisc::DoPeek()
+{
+    return m_queue->Peek();
+}
+
+/**
+ * @brief QueueDisc::Mark marks the item's header and counts the mark in the statistics.
+ *
+ * @param item The item whose packet the scheduler marked.
+ * @return true if the item was marked.
+ */
+bool
+DiffServQueueDisc::MarkItem(Ptr<QueueDiscItem> item)
+{
+    return Mark(item, SCHEDULER_MARK);
+}
+
+/**
+ * @brief Build the scheduler from the configuration file and wrap it in the internal queue.
+ *        A shaped scheduler that cannot send restarts the queue disc itself once a class
+ *        conforms again.
+ *
+ * @return false if the queue disc was given classes, filters or queues of its own, or no
+ *         configuration file.
+ */
+bool
+DiffServQueueDisc::CheckConfig()
+{
+    if (GetNQueueDiscClasses() > 0)
+    {
+        NS_LOG_ERROR("DiffServQueueDisc cannot have classes");
+        return false;
+    }
+    if (GetNPacketFilters() > 0)
+    {
+        NS_LOG_ERROR("DiffServQueueDisc classifies by the filters of its configuration file");
+        return false;
+    }
+    if (GetNInternalQueues() > 0)
+    {
+        NS_LOG_ERROR("DiffServQueueDisc creates its internal queue itself");
+        return false;
+    }
+    if (m_configFile.empty())
+    {
+        NS_LOG_ERROR("DiffServQueueDisc needs a configuration file");
+        return false;
+    }
+
+    ObjectFactory factory;
+    factory.SetTypeId(QosInitializer::GetQueueTypeFromJson(m_configFile));
+    factory.Set("Config", StringValue(m_configFile));
+    Ptr<DiffServ> scheduler = factory.Create<DiffServ>();
+    scheduler->Initialize();
+    scheduler->SetWakeCallback(MakeCallback(&QueueDisc::Run, this));
+
+    m_queue = CreateObject<DiffServItemQueue>();
+    m_queue->SetScheduler(scheduler);
+    m_queue->SetMarkCallback(MakeCallback(&DiffServQueueDisc::MarkItem, this));
+    AddInternalQueue(m_queue);
+    return true;
+}
+
+/**
+ * @brief Everything is set up by CheckConfig.
+ */
+void
+DiffServQueueDisc::InitializeParams()
+{
+}
+
+} // namespace ns3
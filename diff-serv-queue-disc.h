@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef DIFF_SERV_QUEUE_DISC_H
+#define DIFF_SERV_QUEUE_DISC_H
+
+#include "diff-serv.h"
+
+#include "ns3/queue-disc.h"
+
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * @brief Internal queue of DiffServQueueDisc, handing out QueueDiscItems in the order a DiffServ
+ *        scheduler decides.
+ *
+ * The items stay in the container of Queue<QueueDiscItem>, which counts them and fires the
+ * trace sources the queue disc keeps its statistics with, while a copy of each IP packet goes
+ * through the scheduler. The items themselves are left as the traffic control layer expects
+ * them, with their IPv4 header kept apart until the device sends them. Each copy maps back to
+ * the position of its item, so that dequeues and the drops the scheduler decides on its own
+ * (push-out, CoDel, expired deadlines) cost O(1).
+ */
+class DiffServItemQueue : public Queue<QueueDiscItem>
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Create an empty queue; the scheduler enforces every limit, so the queue has none.
+     */
+    DiffServItemQueue();
+
+    /**
+     * @brief Set the scheduler that classifies and orders the items.
+     *
+     * @param scheduler An initialized scheduler holding no packets.
+     */
+    void SetScheduler(Ptr<DiffServ> scheduler);
+
+    /**
+     * @brief Get the scheduler, e.g. to read its per-class statistics.
+     *
+     * @return The scheduler.
+     */
+    Ptr<DiffServ> GetScheduler() const;
+
+    /**
+     * @brief Set the callback that marks an item whose packet the scheduler CE-marked.
+     *
+     * @param cb Callback marking the item, returning whether it could be marked.
+     */
+    void SetMarkCallback(Callback<bool, Ptr<QueueDiscItem>> cb);
+
+    /**
+     * @brief Classify an item by its IPv4 header and enqueue it into the scheduler.
+     *
+     * Items without an IPv4 header go to the default class.
+     *
+     * @param item Item to enqueue.
+     * @return true if successfully enqueued, false if it was dropped.
+     */
+    bool Enqueue(Ptr<QueueDiscItem> item) override;
+
+    /**
+     * @brief Dequeue the item of the packet the scheduler sends next.
+     *
+     * @return The item, or nullptr if nothing can be sent.
+     */
+    Ptr<QueueDiscItem> Dequeue() override;
+
+    /**
+     * @brief Drop the item of the packet the scheduler would send next.
+     *
+     * @return The dropped item, or nullptr if nothing can be sent.
+     */
+    Ptr<QueueDiscItem> Remove() override;
+
+    /**
+     * @brief Peek at the item Dequeue would return.
+     *
+     * @return The item, or nullptr if nothing can be sent.
+     */
+    Ptr<const QueueDiscItem> Peek() const override;
+
+  protected:
+    /**
+     * @brief Release the scheduler.
+     */
+    void DoDispose() override;
+
+  private:
+    /**
+     * @brief Find the item of a packet leaving the scheduler and forget it.
+     *
+     * @param p The packet.
+     * @return Position of its item in the container.
+     */
+    ConstIterator TakePosition(Ptr<const Packet> p);
+
+    /**
+     * @brief Remove the item of a packet the scheduler dropped after it had been queued.
+     *
+     * @param p The dropped packet.
+     */
+    void NotifySchedulerDrop(Ptr<const Packet> p);
+
+    /**
+     * @brief Mark an item if the scheduler CE-marked the copy of its packet.
+     *
+     * @param p The packet the scheduler returned.
+     * @param item The item of the packet.
+     */
+    void TransferMark(Ptr<const Packet> p, Ptr<QueueDiscItem> item);
+
+    Ptr<DiffServ> m_scheduler;                                    //!< Orders the packets
+    std::unordered_map<const Packet*, ConstIterator> m_positions; //!< Item of each packet
+    Callback<bool, Ptr<QueueDiscItem>> m_markCallback;            //!< Marks an item
+};
+
+/**
+ * @brief QueueDisc front end of the DiffServ schedulers for the traffic control layer.
+ *
+ * The scheduler is the one named by "type" in the JSON file given by the Config attribute,
+ * configured exactly as on a device queue, so the filters, traffic classes and schedulers are
+ * the same. Packets are classified by the IPv4 header of their QueueDiscItem, before any link
+ * layer header is added. Installed as the root queue disc with TrafficControlHelper, it is
+ * stopped and woken by the device through flow control (and byte queue limits, if enabled),
+ * so the device queue itself can be reduced to a packet or two and no longer adds delay behind
+ * the scheduler.
+ */
+class DiffServQueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Default constructor; the limits are those of the traffic classes.
+     */
+    DiffServQueueDisc();
+
+    /**
+     * @brief Get the scheduler, e.g. to call ReportSojournTimes at the end of a run.
+     *
+     * @return The scheduler, or nullptr before the queue disc is initialized.
+     */
+    Ptr<DiffServ> GetScheduler() const;
+
+  protected:
+    /**
+     * @brief Release the internal queue and its scheduler.
+     */
+    void DoDispose() override;
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    Ptr<const QueueDiscItem> DoPeek() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+
+    /**
+     * @brief Mark an item the scheduler CE-marked, counting it in the queue disc statistics.
+     *
+     * @param item The item.
+     * @return true if the item was marked.
+     */
+    bool MarkItem(Ptr<QueueDiscItem> item);
+
+    std::string m_configFile; // <- come from SetAttribute
+
+    Ptr<DiffServItemQueue> m_queue; //!< The internal queue, holding the scheduler
+};
+
+} // namespace ns3
+
+#endif // DIFF_SERV_QUEUE_DISC_H
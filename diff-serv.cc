@@ -8,15 +8,76 @@
 
 #include "diff-serv.h"
 
+#include "packet-parser.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <limits>
+
 namespace ns3
 {
 
+/** Slot width of the conforming time calendar in ns; the wheel then spans about 400 ms */
+static const double CONFORM_SLOT_WIDTH = 100e3;
+
+TypeId
+DiffServ::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::DiffServ")
+            .SetParent<Queue<Packet>>()
+            .SetGroupName("Network")
+            .AddAttribute("SharedLimit",
+                          "Packets all traffic classes may hold together (0 disables the limit)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&DiffServ::m_sharedLimit),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("PushOut",
+                          "Packet evicted to admit an arrival once SharedLimit is reached",
+                          EnumValue(DiffServ::PUSH_OUT_NONE),
+                          MakeEnumAccessor<PushOutPolicy>(&DiffServ::m_pushOut),
+                          MakeEnumChecker(DiffServ::PUSH_OUT_NONE,
+                                          "None",
+                                          DiffServ::PUSH_OUT_LONGEST_QUEUE,
+                                          "LongestQueue",
+                                          DiffServ::PUSH_OUT_LOWEST_PRIORITY,
+                                          "LowestPriority"))
+            .AddAttribute("Bypass",
+                          "Hand an arrival to an idle device without scheduling it when nothing "
+                          "is queued, if its class and the scheduler allow it",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&DiffServ::m_bypass),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+DiffServ::DiffServ()
+    : m_sharedLimit(0),
+      m_pushOut(PUSH_OUT_NONE),
+      m_unshapedBacklogged(0),
+      m_generation(1),
+      m_selectionGeneration(0),
+      m_selectionTime(0),
+      m_selection(-1),
+      m_bypass(true),
+      m_deviceIdle(true),
+      m_bypassClass(0)
+{
+    m_backlog.Clear();
+    // The traffic classes enforce the limits, the base class container only mirrors them
+    SetMaxSize(QueueSize(QueueSizeUnit::PACKETS, std::numeric_limits<uint32_t>::max()));
+}
+
 /**
  * @brief Enqueue a packet into the appropriate TrafficClass queue.
  *
  * @param p The packet to enqueue.
  * @return true if enqueue succeeds; false if the packet doesn't match any queue, or the
- * appropriate TrafficClass queue is full.
+ * appropriate TrafficClass queue or the shared buffer is full.
  */
 bool
 DiffServ::Enqueue(Ptr<Packet> p)
@@ -25,37 +86,212 @@ DiffServ::Enqueue(Ptr<Packet> p)
 
     if (index < 0)
     {
+        DropBeforeEnqueue(p);
         return false;
     }
+    return EnqueueToClass(index, p);
+}
 
+/**
+ * @brief Enqueue a packet into a given TrafficClass queue.
+ *
+ * When a shared limit is configured and reached, the push-out policy decides whether a queued
+ * packet is evicted to admit the arrival. The victim is only evicted once the class of the
+ * arrival has accepted it, since its policer, congestion threshold or child scheduler may still
+ * refuse the packet. An admitted packet is also added to the container of
+ * Queue<Packet>, which keeps GetNPackets and GetNBytes right and fires the Enqueue trace source;
+ * a refused one fires DropBeforeEnqueue.
+ *
+ * A packet held in the bypass is queued into its class first, since the device did not take it
+ * before this arrival. If the arrival may bypass the scheduler itself, it is only added to the
+ * container, and the class, backlog tracker and scheduler hooks are left untouched.
+ *
+ * @param index Index of the class the packet was classified into.
+ * @param p The packet to enqueue.
+ * @return true if enqueue succeeds; false if the TrafficClass queue or the shared buffer is full.
+ */
+bool
+DiffServ::EnqueueToClass(uint32_t index, Ptr<Packet> p)
+{
     Ptr<TrafficClass> queue_class = q_class.at(index);
 
-    return queue_class->Enqueue(p);
+    if (m_bypassPacket)
+    {
+        FlushBypass();
+    }
+    if (CanTakeBypass(index))
+    {
+        Iterator position;
+        DoEnqueue(end(), p, position);
+        m_bypassPacket = p;
+        m_bypassClass = index;
+        m_bypassTime = Simulator::Now();
+        m_bypassPosition = position;
+        return true;
+    }
+
+    // A full flow-queued class makes room within itself, which keeps the shared total
+    bool makesRoom = queue_class->IsFull() && queue_class->IsFlowQueued();
+    int32_t victim = -1;
+    if (m_sharedLimit > 0 && m_backlog.GetTotal() >= m_sharedLimit && !makesRoom)
+    {
+        victim = queue_class->IsFull() ? -1 : GetPushOutVictim(index);
+        if (victim < 0)
+        {
+            queue_class->RecordDrop();
+            DropBeforeEnqueue(p);
+            return false;
+        }
+    }
+
+    uint32_t before = queue_class->GetPackets();
+    if (!queue_class->Enqueue(p))
+    {
+        DropBeforeEnqueue(p);
+        return false;
+    }
+    if (victim >= 0)
+    {
+        PushOut(victim);
+    }
+
+    // Cannot fail, the container has no limit of its own
+    Iterator position;
+    DoEnqueue(end(), p, position);
+    m_positions[PeekPointer(p)] = position;
+
+    // Unless the class dropped a queued packet of its fattest flow to admit this one
+    if (queue_class->GetPackets() > before)
+    {
+        m_backlog.Increment(index);
+    }
+    SyncClassState(index);
+    NotifyEnqueue(index);
+    return true;
 }
 
 /**
  * @brief Dequeue a packet based on the scheduling algorithm.
  *
- * @return The dequeued packet, or nullptr if all queues are empty.
+ * If nothing can be sent because every backlogged class is shaped, a wake-up is armed for the
+ * time the first of them conforms again. A packet held in the bypass is the only one queued, so
+ * it is returned without running the scheduler. Finding nothing to send means the device is
+ * idle until it is given the next packet.
+ *
+ * @return The dequeued packet, or nullptr if all queues are empty or out of tokens.
  */
 Ptr<Packet>
 DiffServ::Dequeue()
 {
-    return Schedule();
+    Ptr<Packet> p = m_bypassPacket ? TakeBypass() : Schedule();
+    if (!p)
+    {
+        ScheduleWakeup();
+    }
+    m_deviceIdle = !p;
+    return p;
 }
 
 /**
- * @brief Peek at the first packet from the first non-empty TrafficClass without removing it.
- *        Scans the traffic classes in order and returns the first non-empty one.
+ * @brief Dequeue several packets of one class with a single scheduling decision.
  *
- * @return The front packet of the first non-empty queue, or nullptr if empty.
+ * @param maxPackets Largest number of packets to return.
+ * @param maxBytes Byte budget; the first packet is returned even if it alone exceeds it.
+ * @return The dequeued packets, or an empty vector if nothing can be sent.
+ */
+std::vector<Ptr<Packet>>
+DiffServ::DequeueBurst(uint32_t maxPackets, uint32_t maxBytes)
+{
+    if (maxPackets == 0)
+    {
+        return {};
+    }
+    if (m_bypassPacket)
+    {
+        m_deviceIdle = false;
+        return {TakeBypass()};
+    }
+
+    std::vector<Ptr<Packet>> burst = ScheduleBurst(maxPackets, maxBytes);
+    if (burst.empty())
+    {
+        ScheduleWakeup();
+    }
+    m_deviceIdle = burst.empty();
+    return burst;
+}
+
+/**
+ * @brief The selected class keeps sending while GetBurstBytes allows it. As in
+ *        DequeueFromClass, the class is charged before it is reported drained. A class whose
+ *        child scheduler dropped all it held sends nothing, and the selection is made again.
+ *
+ * @param maxPackets Largest number of packets to return.
+ * @param maxBytes Byte budget; the first packet is returned even if it alone exceeds it.
+ * @return The dequeued packets, or an empty vector if no class may send.
+ */
+std::vector<Ptr<Packet>>
+DiffServ::ScheduleBurst(uint32_t maxPackets, uint32_t maxBytes)
+{
+    while (true)
+    {
+        int32_t index = SelectClass();
+        if (index < 0)
+        {
+            return {};
+        }
+        CommitSelection(index);
+
+        uint32_t budget = std::min(maxBytes, GetBurstBytes(index));
+        budget = std::max(budget, m_headSizes[index]);
+
+        Ptr<TrafficClass> tc = q_class[index];
+        uint32_t before = tc->GetPackets();
+        std::vector<Ptr<Packet>> burst = tc->DequeueBurst(maxPackets, budget);
+
+        for (uint32_t removed = before - tc->GetPackets(); removed > 0; --removed)
+        {
+            m_backlog.Decrement(index);
+        }
+        bool drained = RefreshClassState(index);
+        uint32_t bytes = 0;
+        for (const Ptr<Packet>& p : burst)
+        {
+            DoDequeue(TakePosition(p));
+            bytes += p->GetSize();
+        }
+        if (!burst.empty())
+        {
+            ChargeClass(index, bytes);
+        }
+        if (drained)
+        {
+            NotifyDrained(index);
+        }
+        if (!burst.empty())
+        {
+            return burst;
+        }
+    }
+}
+
+/**
+ * @brief Peek at the head packet of the class the scheduler would serve next, without removing
+ *        it or changing any scheduler state. The decision is cached for the following Dequeue.
+ *
+ * @return The packet Dequeue would return, or nullptr if nothing can be sent.
  */
 Ptr<const Packet>
 DiffServ::Peek() const
 {
-    int index = GetQueueForSchedule();
+    if (m_bypassPacket)
+    {
+        return m_bypassPacket;
+    }
 
-    if (index < 0 || q_class[index]->GetPackets() == 0)
+    int index = SelectClass();
+
+    if (index < 0 || m_backlogs[index] == 0)
     {
         return nullptr;
     }
@@ -65,14 +301,19 @@ DiffServ::Peek() const
 }
 
 /**
- * @brief Remove a packet from the queue (alias for Dequeue).
+ * @brief Remove the next scheduled packet from the queue and count it as dropped.
  *
  * @return The removed packet, or nullptr if all queues are empty.
  */
 Ptr<Packet>
 DiffServ::Remove()
 {
-    return Schedule();
+    Ptr<Packet> p = m_bypassPacket ? TakeBypass() : Schedule();
+    if (p)
+    {
+        DropAfterDequeue(p);
+    }
+    return p;
 }
 
 /**
@@ -105,7 +346,606 @@ DiffServ::GetTrafficClasses() const
 void
 DiffServ::AddTrafficClass(Ptr<TrafficClass> trafficClass)
 {
+    NS_ABORT_MSG_IF(q_class.size() >= PriorityBitmap::MAX_SLOTS,
+                    "DiffServ supports at most " << PriorityBitmap::MAX_SLOTS << " classes");
     q_class.push_back(trafficClass);
+    trafficClass->SetDropCallback(MakeCallback(&DiffServ::NotifyClassDrop, this));
+    ResetClassState();
+}
+
+/**
+ * @brief Parse the headers once and classify by them. A packet without an IPv4 header only
+ *        fits the default class.
+ */
+int32_t
+DiffServ::ClassifyByFilters(Ptr<Packet> p) const
+{
+    Ipv4Header header;
+    Ptr<Packet> payload;
+    if (!PacketParser::ParseIpv4(p, header, payload))
+    {
+        return GetDefaultClass();
+    }
+    return ClassifyHeader(header, payload);
+}
+
+/**
+ * @brief Returns the index of the first class with a matching filter, or the default class.
+ */
+int32_t
+DiffServ::ClassifyHeader(const Ipv4Header& header, Ptr<const Packet> payload) const
+{
+    for (uint32_t i = 0; i < q_class.size(); ++i)
+    {
+        if (q_class[i]->Match(header, payload))
+            return i;
+    }
+
+    // If a packet doesn't match any of the queue, place it in the default queue
+    return GetDefaultClass();
+}
+
+/**
+ * @brief Returns the index of the first class marked as default.
+ */
+int32_t
+DiffServ::GetDefaultClass() const
+{
+    for (uint32_t i = 0; i < q_class.size(); ++i)
+    {
+        if (q_class[i]->IsDefault())
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Run GetQueueForSchedule unless the cached decision is still valid. A decision stays
+ *        valid while no class changed and the simulation time did not advance, since token
+ *        buckets are the only other input of the schedulers.
+ *
+ * @return Index of the class to serve, or -1 if none may send.
+ */
+int32_t
+DiffServ::SelectClass() const
+{
+    Time now = Simulator::Now();
+    if (m_selectionGeneration != m_generation || m_selectionTime != now)
+    {
+        m_selection = GetQueueForSchedule();
+        m_selectionGeneration = m_generation;
+        m_selectionTime = now;
+    }
+    return m_selection;
+}
+
+/**
+ * @brief By default a scheduling decision has no side effects.
+ *
+ * @param index Index of the selected class.
+ */
+void
+DiffServ::CommitSelection(uint32_t index)
+{
+}
+
+/**
+ * @brief Each pass either returns a packet or leaves the selected class empty, since a child
+ *        scheduler that cannot send at all makes its class ineligible. The loop therefore ends.
+ *
+ * @return The dequeued packet, or nullptr if no class may send.
+ */
+Ptr<Packet>
+DiffServ::ServeSelection()
+{
+    while (true)
+    {
+        int32_t index = SelectClass();
+        if (index < 0)
+        {
+            return nullptr;
+        }
+        CommitSelection(index);
+
+        Ptr<Packet> p = DequeueFromClass(index);
+        if (p)
+        {
+            return p;
+        }
+    }
+}
+
+/**
+ * @brief Make the next SelectClass call run the scheduler again.
+ */
+void
+DiffServ::InvalidateSelection()
+{
+    m_generation++;
+}
+
+/**
+ * @brief Remove the head packet of a class on behalf of the scheduler.
+ *
+ * @param index Index of the class to serve.
+ * @return The dequeued packet, or nullptr if the class is empty.
+ */
+Ptr<Packet>
+DiffServ::DequeueFromClass(uint32_t index)
+{
+    Ptr<TrafficClass> tc = q_class[index];
+    uint32_t before = tc->GetPackets();
+    Ptr<Packet> p = tc->Dequeue();
+
+    // A class running CoDel may drop packets on dequeue as well
+    for (uint32_t removed = before - tc->GetPackets(); removed > 0; --removed)
+    {
+        m_backlog.Decrement(index);
+    }
+    bool drained = RefreshClassState(index);
+    if (p)
+    {
+        DoDequeue(TakePosition(p));
+        ChargeClass(index, p->GetSize());
+    }
+    if (drained)
+    {
+        NotifyDrained(index);
+    }
+    return p;
+}
+
+/**
+ * @brief By default a scheduler keeps no per-arrival state.
+ *
+ * @param index Index of the class that received the packet.
+ */
+void
+DiffServ::NotifyEnqueue(uint32_t index)
+{
+}
+
+/**
+ * @brief By default a scheduler keeps no state for empty classes.
+ *
+ * @param index Index of the class that became empty.
+ */
+void
+DiffServ::NotifyDrained(uint32_t index)
+{
+}
+
+/**
+ * @brief By default a selected class may send until it is empty or out of tokens.
+ *
+ * @param index Index of the selected class.
+ * @return The byte allowance of the class.
+ */
+uint32_t
+DiffServ::GetBurstBytes(uint32_t index) const
+{
+    return std::numeric_limits<uint32_t>::max();
+}
+
+/**
+ * @brief By default sending costs nothing beyond the dequeue itself.
+ *
+ * @param index Index of the class.
+ * @param bytes Bytes sent.
+ */
+void
+DiffServ::ChargeClass(uint32_t index, uint32_t bytes)
+{
+}
+
+/**
+ * @brief By default the scheduler is never bypassed.
+ *
+ * @param index Index of the class the packet was classified into.
+ * @return false.
+ */
+bool
+DiffServ::CanBypass(uint32_t index) const
+{
+    return false;
+}
+
+/**
+ * @brief Re-register every traffic class with the backlog tracker, in the current order.
+ */
+void
+DiffServ::ResetClassState()
+{
+    m_backlog.Clear();
+    m_backlogs.assign(q_class.size(), 0);
+    m_headSizes.assign(q_class.size(), 0);
+    m_weights.resize(q_class.size());
+    m_shaped.resize(q_class.size());
+    m_deficits.assign(q_class.size(), 0);
+    m_activeClasses.Reset();
+    m_conformTimes.Reset(q_class.size(), CONFORM_SLOT_WIDTH);
+    m_unshapedBacklogged = 0;
+    InvalidateSelection();
+
+    for (uint32_t i = 0; i < q_class.size(); ++i)
+    {
+        m_backlog.AddClass(q_class[i]->GetPriorityLevel());
+        m_weights[i] = q_class[i]->GetWeight();
+        // A class backed by a child scheduler is checked like a shaped one, since the child
+        // may hold packets that none of its own classes may send yet
+        m_shaped[i] = q_class[i]->IsShaped() || q_class[i]->GetChild();
+        SyncClassState(i);
+    }
+}
+
+/**
+ * @brief Refresh the class and tell the scheduler when it has just been emptied.
+ *
+ * @param index Index of the class.
+ */
+void
+DiffServ::SyncClassState(uint32_t index)
+{
+    if (RefreshClassState(index))
+    {
+        NotifyDrained(index);
+    }
+}
+
+/**
+ * @brief Copy the backlog and head packet size of a class into the scheduler arrays, and
+ *        keep its bit in the active class bitmap in step. A backlogged shaped class is filed in
+ *        the conforming time calendar; its next conforming time only changes when the class
+ *        itself does, so this keeps the calendar exact. Any cached selection is dropped.
+ *
+ * @param index Index of the class.
+ * @return true if the class has just become empty.
+ */
+bool
+DiffServ::RefreshClassState(uint32_t index)
+{
+    InvalidateSelection();
+
+    Ptr<TrafficClass> tc = q_class[index];
+    bool wasBacklogged = m_backlogs[index] > 0;
+    m_backlogs[index] = tc->GetPackets();
+    bool isBacklogged = m_backlogs[index] > 0;
+    if (isBacklogged)
+    {
+        // A child scheduler that cannot send yet has no head packet
+        Ptr<Packet> head = tc->Peek();
+        m_headSizes[index] = head ? head->GetSize() : 0;
+        m_activeClasses.Set(index);
+    }
+    else
+    {
+        m_headSizes[index] = 0;
+        m_activeClasses.Clear(index);
+    }
+
+    if (!m_shaped[index])
+    {
+        if (isBacklogged && !wasBacklogged)
+            m_unshapedBacklogged++;
+        else if (!isBacklogged && wasBacklogged)
+            m_unshapedBacklogged--;
+    }
+    else if (isBacklogged)
+    {
+        Time next = tc->GetNextConformingTime();
+        if (next != Time::Max())
+            m_conformTimes.Push(index, next.GetNanoSeconds());
+        else
+            m_conformTimes.Remove(index);
+    }
+    else
+    {
+        m_conformTimes.Remove(index);
+    }
+
+    return wasBacklogged && !isBacklogged;
+}
+
+/**
+ * @brief Eligibility test used by the schedulers; only shaped classes touch the TrafficClass.
+ *
+ * @param index Index of the class.
+ * @return true if the class is backlogged and within its token bucket.
+ */
+bool
+DiffServ::IsEligible(uint32_t index) const
+{
+    return m_backlogs[index] > 0 && (!m_shaped[index] || q_class[index]->IsConforming());
+}
+
+/**
+ * @brief Choose the victim class of the push-out policy, without evicting anything.
+ *
+ * There is none when the class of the arrival is at least as long as the longest class, or when no
+ * backlogged class has a lower priority level than the arrival's class. The victim is therefore
+ * never the class of the arrival.
+ *
+ * @param index Index of the class the arriving packet belongs to.
+ * @return Index of the victim class, or -1 if the arrival should be dropped.
+ */
+int32_t
+DiffServ::GetPushOutVictim(uint32_t index) const
+{
+    int32_t victim = -1;
+    if (m_pushOut == PUSH_OUT_LONGEST_QUEUE)
+    {
+        victim = m_backlog.GetLongest();
+        if (victim >= 0 && m_backlog.GetLength(victim) <= m_backlog.GetLength(index))
+        {
+            victim = -1;
+        }
+    }
+    else if (m_pushOut == PUSH_OUT_LOWEST_PRIORITY)
+    {
+        victim = m_backlog.GetLowestPriority();
+        if (victim >= 0 &&
+            q_class[victim]->GetPriorityLevel() >= q_class[index]->GetPriorityLevel())
+        {
+            victim = -1;
+        }
+    }
+
+    return victim;
+}
+
+/**
+ * @brief Evict one packet from the tail of the victim class.
+ *
+ * @param victim Index of the class to evict from.
+ */
+void
+DiffServ::PushOut(uint32_t victim)
+{
+    Ptr<Packet> dropped = q_class[victim]->DropTail();
+    m_backlog.Decrement(victim);
+    SyncClassState(victim);
+    DoRemove(TakePosition(dropped));
+}
+
+/**
+ * @brief Take a packet a class dropped from its queue out of the base class container, which
+ *        fires the drop trace sources. The operation the drop happened in brings the backlog
+ *        of the class up to date.
+ *
+ * @param p The dropped packet.
+ */
+void
+DiffServ::NotifyClassDrop(Ptr<const Packet> p)
+{
+    DoRemove(TakePosition(p));
+}
+
+/**
+ * @brief Look up and forget the base class container entry of a packet leaving the queue.
+ *
+ * @param p The packet, which must have been enqueued.
+ * @return Its position in the container.
+ */
+DiffServ::ConstIterator
+DiffServ::TakePosition(Ptr<const Packet> p)
+{
+    auto it = m_positions.find(PeekPointer(p));
+    NS_ASSERT_MSG(it != m_positions.end(), "Packet left a traffic class without being enqueued");
+    ConstIterator position = it->second;
+    m_positions.erase(it);
+    return position;
+}
+
+/**
+ * @brief An empty class that is neither shaped, policed nor backed by a child admits a packet
+ *        unconditionally, so holding the packet back does not change whether it is dropped.
+ *
+ * @param index Index of the class the packet was classified into.
+ * @return true if the packet may be held in the bypass.
+ */
+bool
+DiffServ::CanTakeBypass(uint32_t index) const
+{
+    if (!m_bypass || !m_deviceIdle || m_bypassPacket || m_backlog.GetTotal() > 0)
+    {
+        return false;
+    }
+    Ptr<TrafficClass> tc = q_class[index];
+    return !m_shaped[index] && !tc->IsPoliced() && !tc->IsFull() && CanBypass(index);
+}
+
+/**
+ * @brief The packet leaves through DoDequeue and its sojourn time is recorded by its class,
+ *        exactly as when a scheduler dequeues it.
+ *
+ * @return The held packet.
+ */
+Ptr<Packet>
+DiffServ::TakeBypass()
+{
+    Ptr<Packet> p = m_bypassPacket;
+    m_bypassPacket = nullptr;
+    q_class[m_bypassClass]->RecordSojourn(Simulator::Now() - m_bypassTime);
+    DoDequeue(m_bypassPosition);
+    return p;
+}
+
+/**
+ * @brief The class is still empty and admits the packet as it would have on arrival. The
+ *        packet keeps its entry in the base class container, so no trace source fires again.
+ */
+void
+DiffServ::FlushBypass()
+{
+    Ptr<Packet> p = m_bypassPacket;
+    uint32_t index = m_bypassClass;
+    m_bypassPacket = nullptr;
+
+    bool admitted = q_class[index]->Enqueue(p, m_bypassTime);
+    NS_ASSERT_MSG(admitted, "Traffic class refused a packet held in the bypass");
+    m_positions[PeekPointer(p)] = m_bypassPosition;
+
+    m_backlog.Increment(index);
+    SyncClassState(index);
+    NotifyEnqueue(index);
+}
+
+/**
+ * @brief Register the callback that restarts transmission once a shaped class conforms.
+ *
+ * @param cb The callback to invoke at the next token time.
+ */
+void
+DiffServ::SetWakeCallback(Callback<void> cb)
+{
+    m_wakeCallback = cb;
+}
+
+/**
+ * @brief Total backlog as kept by the backlog tracker, plus a packet held in the bypass.
+ *
+ * @return Packets queued in all classes.
+ */
+uint32_t
+DiffServ::GetBackloggedPackets() const
+{
+    return m_backlog.GetTotal() + (m_bypassPacket ? 1 : 0);
+}
+
+/**
+ * @brief Evict from the tail of the longest class, as the LongestQueue push-out policy does.
+ *        The packet only counts as dequeued here; the parent scheduler counts the drop.
+ *
+ * @return The dropped packet, or nullptr if all queues are empty.
+ */
+Ptr<Packet>
+DiffServ::DropTail()
+{
+    if (m_bypassPacket)
+    {
+        FlushBypass();
+    }
+
+    int32_t victim = m_backlog.GetLongest();
+    if (victim < 0)
+    {
+        return nullptr;
+    }
+
+    Ptr<Packet> p = q_class[victim]->DropTail();
+    m_backlog.Decrement(victim);
+    SyncClassState(victim);
+    if (p)
+    {
+        DoDequeue(TakePosition(p));
+    }
+    return p;
+}
+
+/**
+ * @brief A backlogged unshaped class or a packet held in the bypass may always send; otherwise
+ *        the earliest entry of the conforming time calendar, which may already have passed.
+ *
+ * @return The earliest time a class may send, or Time::Max() if none is backlogged.
+ */
+Time
+DiffServ::GetNextConformingTime() const
+{
+    Time now = Simulator::Now();
+    if (m_unshapedBacklogged > 0 || m_bypassPacket)
+    {
+        return now;
+    }
+    if (m_conformTimes.GetSize() == 0)
+    {
+        return Time::Max();
+    }
+    return std::max(now, NanoSeconds(static_cast<int64_t>(m_conformTimes.TopKey())));
+}
+
+/**
+ * @brief A child scheduler is only checked through its own classes, since the class holding it
+ *        is marked shaped for the scheduler arrays whether or not the child ever stalls.
+ *
+ * @return true if no class is shaped, at any level of the hierarchy.
+ */
+bool
+DiffServ::IsWorkConserving() const
+{
+    for (const Ptr<TrafficClass>& tc : q_class)
+    {
+        Ptr<DiffServ> child = tc->GetChild();
+        if (tc->IsShaped() || (child && !child->IsWorkConserving()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Print one line of sojourn time percentiles per traffic class.
+ *
+ * @param os Stream to write the report to.
+ */
+void
+DiffServ::ReportSojournTimes(std::ostream& os) const
+{
+    for (uint32_t i = 0; i < q_class.size(); ++i)
+    {
+        const SojournHistogram& h = q_class[i]->GetSojournHistogram();
+        os << "class " << i << ": packets=" << h.GetCount()
+           << " p50=" << h.GetPercentile(0.5).GetMicroSeconds() << "us"
+           << " p99=" << h.GetPercentile(0.99).GetMicroSeconds() << "us"
+           << " p999=" << h.GetPercentile(0.999).GetMicroSeconds() << "us"
+           << " max=" << h.GetMax().GetMicroSeconds() << "us" << std::endl;
+    }
+}
+
+/**
+ * @brief Schedule a single wake-up at the earliest time a backlogged class conforms again.
+ */
+void
+DiffServ::ScheduleWakeup()
+{
+    if (m_wakeCallback.IsNull())
+    {
+        return;
+    }
+
+    Time next = GetNextConformingTime();
+    if (next == Time::Max())
+    {
+        return; // nothing is backlogged, the next enqueue restarts transmission
+    }
+
+    m_wakeEvent.Cancel();
+    m_wakeEvent = Simulator::Schedule(next - Simulator::Now(), &DiffServ::Wake, this);
+}
+
+/**
+ * @brief Fire the registered wake callback.
+ */
+void
+DiffServ::Wake()
+{
+    if (!m_wakeCallback.IsNull())
+    {
+        m_wakeCallback();
+    }
+}
+
+/**
+ * @brief Release the wake-up event and callback before the queue is destroyed.
+ */
+void
+DiffServ::DoDispose()
+{
+    m_wakeEvent.Cancel();
+    m_wakeCallback.Nullify();
+    m_positions.clear();
+    m_bypassPacket = nullptr;
+    Queue<Packet>::DoDispose();
 }
 
 } // namespace ns3
@@ -9,10 +9,17 @@
 #ifndef DIFF_SERV_H
 #define DIFF_SERV_H
 
+#include "backlog-tracker.h"
+#include "calendar-queue.h"
+#include "priority-bitmap.h"
 #include "traffic-class.h"
 
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
 #include "ns3/queue.h"
 
+#include <unordered_map>
+
 namespace ns3
 {
 
@@ -24,17 +31,146 @@ namespace ns3
  */
 class DiffServ : public Queue<Packet>
 {
+  public:
+    /**
+     * @brief Which packet to evict when the shared buffer limit is reached.
+     */
+    enum PushOutPolicy
+    {
+        PUSH_OUT_NONE,            //!< Drop the arriving packet (shared tail drop)
+        PUSH_OUT_LONGEST_QUEUE,   //!< Evict from the tail of the longest class
+        PUSH_OUT_LOWEST_PRIORITY, //!< Evict from the tail of the lowest-priority class
+    };
+
   private:
     std::vector<Ptr<TrafficClass>> q_class; //!< A collection of Traffic Class
+    uint32_t m_sharedLimit;                 //!< Packets all classes may hold together (0 = none)
+    PushOutPolicy m_pushOut;                //!< Victim selection once m_sharedLimit is reached
+    BacklogTracker m_backlog;               //!< Per-class backlog used to find push-out victims
+    Callback<void> m_wakeCallback;          //!< Restarts transmission once a class conforms
+    EventId m_wakeEvent;                    //!< Pending wake-up at the next token time
+    CalendarQueue m_conformTimes;           //!< Backlogged shaped classes by conforming time
+    uint32_t m_unshapedBacklogged;          //!< Backlogged classes that are not shaped
+    uint64_t m_generation;                  //!< Bumped whenever the scheduler state changes
+    mutable uint64_t m_selectionGeneration; //!< m_generation the cached selection was made at
+    mutable Time m_selectionTime;           //!< Simulation time the cached selection was made at
+    mutable int32_t m_selection;            //!< Cached result of GetQueueForSchedule
+
+    // Every queued packet is also kept in the container of Queue<Packet>, so that the base
+    // class counts it and fires its trace sources. Schedulers dequeue from the traffic classes,
+    // so each packet maps back to its entry there.
+    std::unordered_map<const Packet*, ConstIterator> m_positions; //!< Entry of each packet
+
+    // Scheduler bypass. An arrival that finds the scheduler empty while the device is idle is
+    // held here rather than in its class, and handed to the next dequeue without a decision.
+    bool m_bypass;                  //!< Whether idle arrivals may bypass the scheduler
+    bool m_deviceIdle;              //!< Whether the last dequeue found nothing to send
+    Ptr<Packet> m_bypassPacket;     //!< Packet held in the bypass, nullptr if none
+    uint32_t m_bypassClass;         //!< Class the held packet was classified into
+    Time m_bypassTime;              //!< Arrival time of the held packet
+    ConstIterator m_bypassPosition; //!< Entry of the held packet in the base class container
 
     /**
      * @brief Find the index of the next queue to be scheduled.
      *
+     * Must not modify scheduler state: the decision is cached by SelectClass and only applied
+     * through CommitSelection once a packet is actually dequeued.
+     *
      * @return Index of the queue, or -1 if no queue is ready for shceduling.
      */
     virtual int32_t GetQueueForSchedule() const = 0;
 
+    /**
+     * @brief Arrange for the wake callback to fire when the earliest shaped class conforms.
+     *
+     * Called when backlogged classes exist but none of them may send yet, so that the
+     * transmitter is restarted exactly at the next token time instead of polling.
+     */
+    void ScheduleWakeup();
+
+    /**
+     * @brief Invoke the wake callback, if one is registered.
+     */
+    void Wake();
+
+    /**
+     * @brief Find the class whose tail packet makes room for an arrival according to m_pushOut.
+     *
+     * @param index Index of the class the arriving packet was classified into.
+     * @return Index of the victim class, or -1 if the arrival itself should be dropped.
+     */
+    int32_t GetPushOutVictim(uint32_t index) const;
+
+    /**
+     * @brief Evict the tail packet of a class to make room for an admitted arrival.
+     *
+     * @param victim Index of the class returned by GetPushOutVictim.
+     */
+    void PushOut(uint32_t victim);
+
+    /**
+     * @brief Refresh the scheduler arrays of one class after its queue changed.
+     *
+     * @param index Index of the class.
+     */
+    void SyncClassState(uint32_t index);
+
+    /**
+     * @brief Refresh the scheduler arrays of one class without telling the scheduler that it
+     *        drained, for callers that must charge the class first.
+     *
+     * @param index Index of the class.
+     * @return true if the class has just become empty.
+     */
+    bool RefreshClassState(uint32_t index);
+
+    /**
+     * @brief Report a queued packet that a traffic class dropped on its own, e.g. by CoDel.
+     *
+     * @param p The dropped packet.
+     */
+    void NotifyClassDrop(Ptr<const Packet> p);
+
+    /**
+     * @brief Find the base class container entry of a packet leaving the queue and forget it.
+     *
+     * @param p The packet.
+     * @return Its position in the container.
+     */
+    ConstIterator TakePosition(Ptr<const Packet> p);
+
+    /**
+     * @brief Check whether an arrival may be held in the bypass instead of its class.
+     *
+     * @param index Index of the class the packet was classified into.
+     * @return true if nothing is queued, the device is idle and the class would admit the
+     *         packet unconditionally.
+     */
+    bool CanTakeBypass(uint32_t index) const;
+
+    /**
+     * @brief Hand out the packet held in the bypass as if it had been dequeued from its class.
+     *
+     * @return The held packet.
+     */
+    Ptr<Packet> TakeBypass();
+
+    /**
+     * @brief Queue the packet held in the bypass into its class with its original arrival time,
+     *        once another packet arrives before the device took it.
+     */
+    void FlushBypass();
+
   public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    DiffServ();
+
     /**
      * @brief Enqueue a packet into its classified traffic class.
      *
@@ -43,6 +179,17 @@ class DiffServ : public Queue<Packet>
      */
     bool Enqueue(Ptr<Packet> p) override;
 
+    /**
+     * @brief Enqueue a packet that has already been classified.
+     *
+     * Applies the shared limit and the limits of the class exactly as Enqueue does.
+     *
+     * @param index Index of the traffic class, as returned by Classify or ClassifyHeader.
+     * @param p Packet to enqueue.
+     * @return true if successfully enqueued, false if the packet was dropped.
+     */
+    bool EnqueueToClass(uint32_t index, Ptr<Packet> p);
+
     /**
      * @brief Dequeue the next scheduled packet.
      *
@@ -50,6 +197,19 @@ class DiffServ : public Queue<Packet>
      */
     Ptr<Packet> Dequeue() override;
 
+    /**
+     * @brief Dequeue up to maxPackets packets under a single scheduling decision.
+     *
+     * The scheduler selects one class, which then sends consecutive packets as long as the
+     * scheduler allows it (deficit for DRR, eligibility for SPQ). The first packet is always
+     * returned, later ones only while the burst stays within maxBytes.
+     *
+     * @param maxPackets Largest number of packets to return.
+     * @param maxBytes Byte budget for the burst.
+     * @return The dequeued packets in transmission order, empty if nothing can be sent.
+     */
+    std::vector<Ptr<Packet>> DequeueBurst(uint32_t maxPackets, uint32_t maxBytes);
+
     /**
      * @brief Remove the next scheduled packet.
      *
@@ -79,14 +239,221 @@ class DiffServ : public Queue<Packet>
      */
     virtual int32_t Classify(Ptr<Packet> p) = 0; // abstract method
 
+    /**
+     * @brief Classify a packet whose IPv4 header is already parsed, e.g. by the traffic control
+     *        layer, by the filters of the traffic classes as every scheduler does.
+     *
+     * @param header The IPv4 header of the packet.
+     * @param payload The packet behind the IPv4 header.
+     * @return Index of the first class whose filters match, else of the default class, else -1.
+     */
+    int32_t ClassifyHeader(const Ipv4Header& header, Ptr<const Packet> payload) const;
+
+    /**
+     * @brief Get the class packets matching no filter fall into.
+     *
+     * @return Index of the first default class, or -1 if there is none.
+     */
+    int32_t GetDefaultClass() const;
+
     /**
      * @brief Add a new traffic class to the queue set.
      *
+     * At most PriorityBitmap::MAX_SLOTS (4096) classes are supported.
+     *
      * @param trafficClass Pointer to the TrafficClass to add.
      */
     virtual void AddTrafficClass(Ptr<TrafficClass> trafficClass);
 
+    /**
+     * @brief Register the callback used to restart the transmitter after shaping stalls it.
+     *
+     * Dequeue returns nullptr while every backlogged class is out of tokens; the callback is
+     * then invoked once at the time the first of them conforms again.
+     *
+     * @param cb Callback that pulls the next packet from this queue.
+     */
+    void SetWakeCallback(Callback<void> cb);
+
+    /**
+     * @brief Get the number of packets held by all traffic classes together.
+     *
+     * @return The packet count.
+     */
+    uint32_t GetBackloggedPackets() const;
+
+    /**
+     * @brief Drop the most recently queued packet of the longest traffic class.
+     *
+     * Used when this scheduler backs a class of a parent scheduler that pushes that class out.
+     *
+     * @return The dropped packet, or nullptr if all queues are empty.
+     */
+    Ptr<Packet> DropTail();
+
+    /**
+     * @brief Get the earliest time a backlogged traffic class conforms to its token bucket.
+     *
+     * @return The current time if a class may send now, Time::Max() if nothing is backlogged.
+     */
+    Time GetNextConformingTime() const;
+
+    /**
+     * @brief Check whether the scheduler sends whenever it holds packets.
+     *
+     * A scheduler with a shaped class, or with a child scheduler that is not work-conserving,
+     * may hold packets while Dequeue returns nullptr. It then relies on the wake callback to
+     * restart transmission, which only DiffServQueueDisc registers. Such a scheduler cannot be
+     * the queue of a PointToPointNetDevice, which neither checks what Dequeue returns when a
+     * packet arrives to an idle device nor polls the queue again later.
+     *
+     * @return true if no class is shaped, at any level of the hierarchy.
+     */
+    bool IsWorkConserving() const;
+
+    /**
+     * @brief Print p50/p99/p99.9 sojourn times of every traffic class.
+     *
+     * Can be called at the end of a run or scheduled periodically during it.
+     *
+     * @param os Stream to write the report to.
+     */
+    void ReportSojournTimes(std::ostream& os) const;
+
   protected:
+    /**
+     * @brief Cancel any pending wake-up and release the wake callback.
+     */
+    void DoDispose() override;
+
+    /**
+     * @brief Classify a packet by the filters of the traffic classes, in class order.
+     *
+     * Shared implementation of Classify for the schedulers; the packet is parsed once.
+     *
+     * @param p The packet to classify.
+     * @return Index of the first class whose filters match, else of the default class, else -1.
+     */
+    int32_t ClassifyByFilters(Ptr<Packet> p) const;
+
+    /**
+     * @brief Get the class the scheduler would serve now, reusing the last decision if nothing
+     *        changed since.
+     *
+     * Peek followed by Dequeue therefore runs the selection once.
+     *
+     * @return Index of the class, or -1 if no class may send.
+     */
+    int32_t SelectClass() const;
+
+    /**
+     * @brief Apply the side effects of serving the selected class, e.g. DRR quantum credits.
+     *
+     * Called once per scheduling decision, before the class is dequeued from.
+     *
+     * @param index Index of the class returned by SelectClass.
+     */
+    virtual void CommitSelection(uint32_t index);
+
+    /**
+     * @brief Serve the class chosen by SelectClass: apply the decision and dequeue its head
+     *        packet through DequeueFromClass, which charges the class for it.
+     *
+     * The common body of Schedule. A class backed by a child scheduler yields nothing once the
+     * child has dropped all it held, e.g. expired EDF packets; the class is then empty and the
+     * selection is made again.
+     *
+     * @return The dequeued packet, or nullptr if no class may send.
+     */
+    Ptr<Packet> ServeSelection();
+
+    /**
+     * @brief Dequeue consecutive packets of one class under a single scheduling decision.
+     *
+     * Called by DequeueBurst once a packet held in the bypass has been handed out. Schedulers
+     * that check every packet as Schedule does, e.g. against its deadline, override it.
+     *
+     * @param maxPackets Largest number of packets to return, at least one.
+     * @param maxBytes Byte budget; the first packet is returned even if it alone exceeds it.
+     * @return The dequeued packets, or an empty vector if no class may send.
+     */
+    virtual std::vector<Ptr<Packet>> ScheduleBurst(uint32_t maxPackets, uint32_t maxBytes);
+
+    /**
+     * @brief Discard the cached selection. Subclasses call this when state that
+     *        GetQueueForSchedule reads changes outside of enqueue and dequeue, e.g. on a timer.
+     */
+    void InvalidateSelection();
+
+    /**
+     * @brief Dequeue the head packet of a traffic class, update the per-class bookkeeping and
+     *        charge the class for the packet.
+     *
+     * Schedulers must remove packets through this method rather than TrafficClass::Dequeue.
+     * The class is charged before NotifyDrained runs, so the charge still sees the state the
+     * class was served with, e.g. its DRR deficit.
+     *
+     * @param index Index of the class chosen by the scheduler.
+     * @return The dequeued packet, or nullptr if the class is empty.
+     */
+    Ptr<Packet> DequeueFromClass(uint32_t index);
+
+    /**
+     * @brief Called after a packet was added to a class, e.g. to stamp scheduler state.
+     *
+     * @param index Index of the class that received the packet.
+     */
+    virtual void NotifyEnqueue(uint32_t index);
+
+    /**
+     * @brief Called when a class has just become empty, whether it was served, pushed out or
+     *        drained by CoDel.
+     *
+     * @param index Index of the class that became empty.
+     */
+    virtual void NotifyDrained(uint32_t index);
+
+    /**
+     * @brief Get how many bytes the selected class may send under the current decision.
+     *
+     * @param index Index of the class returned by GetQueueForSchedule.
+     * @return The byte allowance; unlimited unless the scheduler overrides it.
+     */
+    virtual uint32_t GetBurstBytes(uint32_t index) const;
+
+    /**
+     * @brief Charge a class for bytes it has just sent, e.g. against its deficit.
+     *
+     * @param index Index of the class.
+     * @param bytes Bytes sent.
+     */
+    virtual void ChargeClass(uint32_t index, uint32_t bytes);
+
+    /**
+     * @brief Check whether a packet arriving to an empty scheduler may skip it.
+     *
+     * A bypassed packet never enters its class, so none of the hooks above run for it. Only a
+     * scheduler whose state after that packet is the same as if it had been served through its
+     * class may allow it, e.g. because the state of a class is reset when it becomes backlogged.
+     *
+     * @param index Index of the class the packet was classified into.
+     * @return true if the packet may bypass the scheduler; false unless overridden.
+     */
+    virtual bool CanBypass(uint32_t index) const;
+
+    /**
+     * @brief Rebuild the per-class bookkeeping after the traffic classes were added or reordered.
+     */
+    void ResetClassState();
+
+    /**
+     * @brief Check whether a class has packets and, if shaped, enough tokens to send its head.
+     *
+     * @param index Index of the class.
+     * @return true if the scheduler may serve the class now.
+     */
+    bool IsEligible(uint32_t index) const;
+
     /**
      * @brief Get modifiable reference of q_class to support sorting of traffic classes
      *
@@ -100,6 +467,16 @@ class DiffServ : public Queue<Packet>
      * @return Const reference to the traffic class vector.
      */
     const std::vector<Ptr<TrafficClass>>& GetTrafficClasses() const; // for read
+
+    // Hot scheduler state, one entry per traffic class in q_class order. The fields are kept in
+    // contiguous arrays so that scanning many classes touches a few cache lines instead of one
+    // TrafficClass object per class.
+    std::vector<uint32_t> m_backlogs;  //!< Packets queued in each class
+    std::vector<uint32_t> m_headSizes; //!< Head packet size of each class, 0 when empty
+    std::vector<uint32_t> m_weights;   //!< Quantum of each class
+    std::vector<uint8_t> m_shaped;     //!< Whether each class may be backlogged yet unable to send
+    std::vector<uint32_t> m_deficits;  //!< Deficit counter of each class
+    PriorityBitmap m_activeClasses;    //!< Bit i is set while q_class[i] is backlogged
 };
 
 } // namespace ns3
@@ -10,10 +10,13 @@
 
 #include "qos-initializer.h"
 
+#include "ns3/abort.h"
+#include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/string.h"
 
 #include <fstream>
+#include <numeric>
 #include <sstream>
 
 #define NS_LOG_COMPONENT_INFO(comp, msg) std::cout << "[" << comp << " INFO] " << msg << std::endl;
@@ -29,11 +32,20 @@ NS_LOG_COMPONENT_DEFINE("DrrQueue");
 namespace ns3
 {
 
+/** Longest weighted round robin round, in slots, that a configuration may lay out */
+static const uint64_t MAX_SEQUENCE_LENGTH = 65536;
+
 NS_OBJECT_ENSURE_REGISTERED(DrrQueue);
 
-// Constructor initializes current index to 0
+// Constructor starts with an empty active list
 DrrQueue::DrrQueue()
-    : m_currentIndex(0)
+    : m_mode(DEFICIT),
+      m_sequencePosition(0),
+      m_selectedPosition(0),
+      m_activeHead(-1),
+      m_activeTail(-1),
+      m_headCredited(false),
+      m_selectedRounds(0)
 {
 }
 
@@ -49,21 +61,33 @@ DrrQueue::GetTypeId()
                                           "Path to DRR configuration file",
                                           StringValue(""),
                                           MakeStringAccessor(&DrrQueue::m_configFile),
-                                          MakeStringChecker());
+                                          MakeStringChecker())
+                            .AddAttribute("Mode",
+                                          "Deficit round robin, surplus round robin where a "
+                                          "class may overdraw its allowance and repay it later, "
+                                          "or weighted round robin with weights in packets; set "
+                                          "it before adding classes",
+                                          EnumValue(DrrQueue::DEFICIT),
+                                          MakeEnumAccessor<Mode>(&DrrQueue::m_mode),
+                                          MakeEnumChecker(DrrQueue::DEFICIT,
+                                                          "Deficit",
+                                                          DrrQueue::SURPLUS,
+                                                          "Surplus",
+                                                          DrrQueue::WEIGHTED_ROUND_ROBIN,
+                                                          "WeightedRoundRobin"));
     return tid;
 }
 
 /**
  * @brief Initializes the DRR queue using a JSON config file.
- *        Parses the configuration, sets up TrafficClasses,
- *        and initializes deficit counters.
+ *        Parses the configuration and sets up TrafficClasses; DiffServ sizes the deficit
+ *        counters as the classes are added.
  */
 void
 DrrQueue::DoInitialize()
 {
     DiffServ::DoInitialize();
     QosInitializer::InitializeDrrFromJson(this, m_configFile);
-    m_deficitCounters.resize(GetTrafficClasses().size(), 0);
 }
 
 /**
@@ -73,99 +97,404 @@ DrrQueue::DoInitialize()
 int32_t
 DrrQueue::Classify(Ptr<Packet> p)
 {
-    const std::vector<Ptr<TrafficClass>>& classes = GetTrafficClasses();
-    for (uint32_t i = 0; i < classes.size(); ++i)
+    return ClassifyByFilters(p);
+}
+
+/**
+ * @brief Add a traffic class. DiffServ resets the per-class arrays, and the active list is
+ *        rebuilt from the classes that are backlogged.
+ */
+void
+DrrQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
+{
+    DiffServ::AddTrafficClass(trafficClass);
+
+    uint32_t n = m_backlogs.size();
+    m_activeNext.assign(n, -1);
+    m_activePrev.assign(n, -1);
+    m_isActive.assign(n, 0);
+    m_debts.assign(n, 0);
+    m_activeHead = -1;
+    m_activeTail = -1;
+    m_headCredited = false;
+    if (m_mode == WEIGHTED_ROUND_ROBIN)
     {
-        if (classes[i]->Match(p))
-            return i;
+        BuildSequence();
     }
-
-    // fallback: return the default queue if available
-    for (uint32_t i = 0; i < classes.size(); ++i)
+    for (uint32_t i = 0; i < n; ++i)
     {
-        if (classes[i]->IsDefault())
-            return i;
+        if (m_backlogs[i] > 0)
+            NotifyEnqueue(i);
     }
-    return -1;
+}
+
+/**
+ * @brief Plain DRR serves every class in the round.
+ */
+bool
+DrrQueue::IsInRound(uint32_t index) const
+{
+    return true;
+}
+
+uint32_t
+DrrQueue::GetDebt(uint32_t index) const
+{
+    return m_debts[index];
 }
 
 /**
  * @brief Schedules the next packet for transmission using the DRR algorithm.
- *        Internally calls GetQueueForSchedule to find the eligible class, remove from the head of
- *        the queue in that class, and decrease deficits.
+ *        Internally calls SelectClass to find the eligible class, credits the quantum earned on
+ *        the way, removes from the head of the queue in that class, and decreases deficits.
  * @return A pointer to the packet to be dequeued, or nullptr if all queues are empty.
  */
 Ptr<Packet>
 DrrQueue::Schedule()
 {
-    int scheduleIndex = GetQueueForSchedule();
+    return ServeSelection();
+}
 
-    if (scheduleIndex == -1)
+/**
+ * @brief The class selected by GetQueueForSchedule may send up to its deficit, or a single
+ *        packet per sequence slot in weighted round robin mode.
+ */
+uint32_t
+DrrQueue::GetBurstBytes(uint32_t index) const
+{
+    return m_mode == WEIGHTED_ROUND_ROBIN ? m_headSizes[index] : m_deficits[index];
+}
+
+/**
+ * @brief Decrease the deficit counter of a class by the bytes it just sent. In surplus mode
+ *        what the deficit does not cover becomes debt, which ends the class's visit.
+ */
+void
+DrrQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    if (m_mode == WEIGHTED_ROUND_ROBIN)
+    {
+        return; // the sequence slot was the whole allowance
+    }
+    if (m_mode == SURPLUS && bytes > m_deficits[index])
     {
-        return nullptr;
+        m_debts[index] += bytes - m_deficits[index];
     }
+    // CoDel in a flow-queued class may deliver a later packet than the one peeked at
+    m_deficits[index] -= std::min(m_deficits[index], bytes);
+}
 
-    const std::vector<Ptr<TrafficClass>>& classes = GetTrafficClasses();
-    Ptr<TrafficClass> tc = classes[scheduleIndex];
-    Ptr<Packet> p = tc->Dequeue();
-    m_deficitCounters[scheduleIndex] -= p->GetSize();
+/**
+ * @brief A class joins the tail of the active list with an empty deficit when its first packet
+ *        arrives.
+ */
+void
+DrrQueue::NotifyEnqueue(uint32_t index)
+{
+    if (!m_isActive[index])
+    {
+        m_deficits[index] = 0;
+        PushActive(index);
+    }
+}
 
-    return p;
+/**
+ * @brief An empty class leaves the active list and forfeits its deficit. A surplus mode debt
+ *        is still repaid once the class returns, so idling does not clear an overdraft.
+ */
+void
+DrrQueue::NotifyDrained(uint32_t index)
+{
+    m_deficits[index] = 0;
+    if (m_isActive[index])
+    {
+        RemoveActive(index);
+    }
+}
+
+/**
+ * @brief In deficit mode a class starts every backlogged period with an empty deficit and
+ *        forfeits it when drained, so a packet sent while the scheduler was empty changes
+ *        nothing. A surplus mode debt or the weighted round robin sequence would have to move.
+ */
+bool
+DrrQueue::CanBypass(uint32_t index) const
+{
+    return m_mode == DEFICIT;
 }
 
 /**
  * @brief Determines which traffic class should be scheduled next, based on the DRR policy.
- *        Iterates over the queue in a round-robin manner and updates deficit counters.
- * @return Index of the selected traffic class, or -1 if all queues are empty.
+ *
+ *        Visiting the active list from its head, a class earns one quantum per visit and, if
+ *        its head packet still does not fit, moves to the tail. The head class has normally
+ *        been credited already and simply keeps sending while its deficit allows, so with a
+ *        quantum of at least one packet the first or second class visited is selected.
+ *
+ *        When quanta are smaller than packets, instead of walking the list round after round,
+ *        each class is asked how many further visits it needs for its head packet, in closed
+ *        form as ceil((head - deficit) / quantum); the class needing the fewest wins, ties going
+ *        to the one visited first. The cost is thus one pass over the active classes at most,
+ *        whatever the packet to quantum ratio. Weights are validated to be positive when the
+ *        configuration is loaded. Backlogged classes that are out of tokens are passed over
+ *        without earning quantum. In surplus mode the same count is made against the class's
+ *        debt instead of its head packet, see GetNeededCredit.
+ * @return Index of the selected traffic class, or -1 if all queues are empty or shaped.
  */
 int32_t
 DrrQueue::GetQueueForSchedule() const
 {
-    const std::vector<Ptr<TrafficClass>>& classes = GetTrafficClasses();
-    uint32_t n = classes.size();
+    if (m_mode == WEIGHTED_ROUND_ROBIN)
+    {
+        return SelectFromSequence();
+    }
+
+    int32_t selected = -1;
 
-    while (true)
+    for (int32_t i = m_activeHead; i >= 0; i = m_activeNext[i])
     {
-        bool anyQueueHasPacket = false;
-        for (uint32_t offset = 0; offset < n; ++offset)
+        if (!IsEligible(i))
         {
-            Ptr<TrafficClass> tc = classes[m_currentIndex];
+            continue;
+        }
 
-            // Skip empty queues as they are not in the activate list
-            if (tc->GetPackets() == 0)
-            {
-                m_deficitCounters[m_currentIndex] = 0; // Set deficit to 0 for empty queue
-                m_currentIndex = (m_currentIndex + 1) % n;
-                continue;
-            }
+        // The deficit after this visit's quantum
+        uint32_t deficit = m_deficits[i];
+        if (i != m_activeHead || !m_headCredited)
+        {
+            deficit += m_weights[i];
+        }
 
-            // At least one queue is not empty
-            anyQueueHasPacket = true;
-            Ptr<Packet> p = classes[m_currentIndex]->Peek();
-            // If packet size is smaller then available deficit, it could be schedule next
-            if (p && p->GetSize() <= m_deficitCounters[m_currentIndex])
-            {
-                return m_currentIndex;
-            }
-            // When the quantum is not enough, add quantum and move to the next queue. We add
-            // quantum before leaving, which is the same as adding quantum the next round this
-            // queue is reached, and guarantees quantum is added only once into any queue for each
-            // round. This solution also works when the deficit counters are all zeros at the very
-            // start: in the first round, we only add quantum and will not schedule any packet,
-            // but expected DRR scheduling will start from the second round.
-            else
+        uint32_t needed = GetNeededCredit(i);
+        uint32_t rounds = 0;
+        if (needed > deficit)
+        {
+            rounds = (needed - deficit + m_weights[i] - 1) / m_weights[i];
+        }
+
+        if (selected == -1 || rounds < m_selectedRounds)
+        {
+            selected = i;
+            m_selectedRounds = rounds;
+            if (rounds == 0)
             {
-                m_deficitCounters[m_currentIndex] += tc->GetWeight();
-                m_currentIndex = (m_currentIndex + 1) % n;
+                break; // nothing comes before a class that can send on this visit
             }
         }
+    }
+
+    return selected;
+}
 
-        // We will stop the loop if all of the queues in q_class are empty
-        if (!anyQueueHasPacket)
+/**
+ * @brief Apply the visits made by GetQueueForSchedule. Classes ahead of the selected one in the
+ *        list are visited once more than those behind it, every visit is worth one quantum
+ *        except the one already credited to the head, and the list is rotated so that the
+ *        selected class is at its head. When the selected class is the head and needs no extra
+ *        round, as in a burst from one class, nothing is touched. In weighted round robin mode
+ *        the sequence simply moves past the slot that was served.
+ */
+void
+DrrQueue::CommitSelection(uint32_t index)
+{
+    if (m_mode == WEIGHTED_ROUND_ROBIN)
+    {
+        uint32_t next = m_selectedPosition + 1;
+        m_sequencePosition = next < m_sequence.size() ? next : 0;
+        return;
+    }
+
+    uint32_t rounds = m_selectedRounds;
+    bool beforeSelected = true;
+
+    for (int32_t i = m_activeHead; i >= 0; i = m_activeNext[i])
+    {
+        if (i == static_cast<int32_t>(index))
         {
-            return -1; // no packets
+            beforeSelected = false;
         }
+        else if (!beforeSelected && rounds == 0)
+        {
+            break; // classes behind the selected one are not reached
+        }
+
+        if (!IsEligible(i))
+        {
+            continue;
+        }
+
+        uint32_t visits = beforeSelected || i == static_cast<int32_t>(index) ? rounds + 1 : rounds;
+        if (i == m_activeHead && m_headCredited)
+        {
+            visits--;
+        }
+        m_deficits[i] += visits * m_weights[i];
+
+        // Quantum goes to paying off a surplus mode debt first
+        uint32_t repaid = std::min(m_deficits[i], m_debts[i]);
+        m_deficits[i] -= repaid;
+        m_debts[i] -= repaid;
+    }
+
+    // Rotate the list: the classes ahead of the selected one move behind it in the same order
+    if (m_activeHead != static_cast<int32_t>(index))
+    {
+        m_activeNext[m_activeTail] = m_activeHead;
+        m_activePrev[m_activeHead] = m_activeTail;
+        m_activeTail = m_activePrev[index];
+        m_activeNext[m_activeTail] = -1;
+        m_activePrev[index] = -1;
+        m_activeHead = index;
+    }
+    m_headCredited = true;
+}
+
+/**
+ * @brief Smooth weighted round robin: every slot each class gains its weight, the class with
+ *        the most gained takes the slot and gives back the total weight. Over one round of
+ *        total-weight slots each class gets exactly its weight, and no class waits longer than
+ *        needed between two slots. Weights are first divided by their greatest common divisor,
+ *        so that byte-sized weights from a DRR configuration that are multiples of one MTU
+ *        still give a short round. Laying out the round costs O(classes x slots), and weights
+ *        whose round would exceed MAX_SEQUENCE_LENGTH slots, e.g. 1500/4500/1501 whose divisor
+ *        is 1, are rejected: they are almost certainly byte quanta meant for deficit mode.
+ *        Classes outside the round get no slots and do not count towards the divisor.
+ */
+void
+DrrQueue::BuildSequence()
+{
+    uint32_t n = m_weights.size();
+    uint32_t divisor = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (IsInRound(i))
+            divisor = std::gcd(divisor, m_weights[i]);
+    }
+
+    std::vector<uint32_t> weights(n, 0);
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < n && divisor > 0; ++i)
+    {
+        if (IsInRound(i))
+        {
+            weights[i] = m_weights[i] / divisor;
+            total += weights[i];
+        }
+    }
+    NS_ABORT_MSG_IF(total > MAX_SEQUENCE_LENGTH,
+                    "Weighted round robin weights give a round of "
+                        << total << " slots, more than " << MAX_SEQUENCE_LENGTH
+                        << "; use packet counts as weights");
+
+    m_sequence.clear();
+    m_sequence.reserve(total);
+    std::vector<int64_t> gained(n, 0);
+    for (uint64_t slot = 0; slot < total; ++slot)
+    {
+        uint32_t best = 0;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            gained[i] += weights[i];
+            if (gained[i] > gained[best])
+                best = i;
+        }
+        gained[best] -= total;
+        m_sequence.push_back(best);
+    }
+    m_sequencePosition = 0;
+}
+
+/**
+ * @brief With every class backlogged this is the slot at the current position, in O(1). Slots
+ *        of classes that cannot send are passed over one by one, so while most of the weight
+ *        belongs to idle or shaped classes a selection walks up to one round, i.e. the sum of
+ *        the reduced weights and at most MAX_SEQUENCE_LENGTH slots.
+ */
+int32_t
+DrrQueue::SelectFromSequence() const
+{
+    if (m_activeClasses.FindFirst() < 0)
+    {
+        return -1;
     }
+
+    uint32_t length = m_sequence.size();
+    uint32_t position = m_sequencePosition;
+    for (uint32_t step = 0; step < length; ++step)
+    {
+        uint32_t index = m_sequence[position];
+        if (IsEligible(index))
+        {
+            m_selectedPosition = position;
+            return index;
+        }
+        position = position + 1 < length ? position + 1 : 0;
+    }
+    return -1;
+}
+
+/**
+ * @brief A deficit counter never holds credit while the class is in debt, so in surplus mode
+ *        one byte beyond the debt is enough to send.
+ */
+uint32_t
+DrrQueue::GetNeededCredit(uint32_t index) const
+{
+    return m_mode == SURPLUS ? m_debts[index] + 1 : m_headSizes[index];
+}
+
+/**
+ * @brief Link a class behind the current tail.
+ */
+void
+DrrQueue::PushActive(uint32_t index)
+{
+    m_isActive[index] = 1;
+    m_activeNext[index] = -1;
+    m_activePrev[index] = m_activeTail;
+    if (m_activeTail >= 0)
+    {
+        m_activeNext[m_activeTail] = index;
+    }
+    else
+    {
+        m_activeHead = index;
+        m_headCredited = false;
+    }
+    m_activeTail = index;
+}
+
+/**
+ * @brief Unlink a class; if it was the head, the next class starts a fresh visit.
+ */
+void
+DrrQueue::RemoveActive(uint32_t index)
+{
+    int32_t prev = m_activePrev[index];
+    int32_t next = m_activeNext[index];
+
+    if (prev >= 0)
+    {
+        m_activeNext[prev] = next;
+    }
+    else
+    {
+        m_activeHead = next;
+        m_headCredited = false;
+    }
+
+    if (next >= 0)
+    {
+        m_activePrev[next] = prev;
+    }
+    else
+    {
+        m_activeTail = prev;
+    }
+
+    m_isActive[index] = 0;
+    m_activeNext[index] = -1;
+    m_activePrev[index] = -1;
 }
 
 } // namespace ns3
@@ -16,10 +16,35 @@ namespace ns3
 
 /**
  * @brief A DiffServ-based class implementing the Deficit Round Robin (DRR) queuing algorithm.
+ *
+ * Backlogged classes are kept on an active list (Shreedhar and Varghese). Each visit to the
+ * head of the list grants one quantum, and a class that cannot send its head packet moves to
+ * the tail. Empty classes are never visited.
+ *
+ * In surplus mode (Surplus/Elastic Round Robin) a class with any allowance left may send its
+ * head packet whatever its size, overdrawing the allowance, and repays the overdraft from the
+ * quantum of its next visits. A class visited with a quantum of at least one packet therefore
+ * always sends on that visit, while the long-term shares stay proportional to the weights.
+ *
+ * In weighted round robin mode the weight counts packets per round instead of bytes, and the
+ * classes are served one packet at a time along a sequence fixed when the classes are added,
+ * in which each class appears weight times, spread out as in smooth weighted round robin. No
+ * packet sizes or deficits are looked at, so with uniform packet sizes the selection is an
+ * array index increment.
  */
 class DrrQueue : public DiffServ
 {
   public:
+    /**
+     * @brief How a class's allowance limits the packets it may send on a visit.
+     */
+    enum Mode
+    {
+        DEFICIT,              //!< The head packet must fit in the deficit counter
+        SURPLUS,              //!< Any positive allowance sends the head packet, repaid later
+        WEIGHTED_ROUND_ROBIN, //!< Weight packets per round along a precomputed sequence
+    };
+
     /**
      * @brief Register this class with the ns-3 type system.
      *
@@ -47,24 +72,146 @@ class DrrQueue : public DiffServ
      */
     int32_t Classify(Ptr<Packet> p) override;
 
+    /**
+     * @brief Add a traffic class and reset the active list.
+     *
+     * @param trafficClass Pointer to the TrafficClass to add.
+     */
+    void AddTrafficClass(Ptr<TrafficClass> trafficClass) override;
+
+    /**
+     * @brief Get the bytes a class overdrew in surplus mode and has not repaid yet.
+     *
+     * @param index Index of the class.
+     * @return The debt in bytes; always zero outside surplus mode.
+     */
+    uint32_t GetDebt(uint32_t index) const;
+
   protected:
     /**
      * @brief Initialize the DRR queue and its configuration.
      */
     void DoInitialize() override;
 
-  private:
-    mutable std::vector<uint32_t> m_deficitCounters; //!< Deficit counters for each class
-    mutable uint32_t m_currentIndex;                 //!< Index of the current class being served
+    /**
+     * @brief A DRR class may keep sending while its head packet fits in its deficit.
+     *
+     * @param index Index of the selected class.
+     * @return The deficit counter of the class.
+     */
+    uint32_t GetBurstBytes(uint32_t index) const override;
 
-    std::string m_configFile; // <- come from SetAttribute
+    /**
+     * @brief Subtract the bytes sent from the deficit counter of the class, or in surplus
+     *        mode record what exceeds it as debt. A class that has just sent its last packet
+     *        is charged before NotifyDrained clears its deficit.
+     *
+     * @param index Index of the class.
+     * @param bytes Bytes sent.
+     */
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    /**
+     * @brief Append a class that just became backlogged to the tail of the active list.
+     *
+     * @param index Index of the class that received a packet.
+     */
+    void NotifyEnqueue(uint32_t index) override;
+
+    /**
+     * @brief Take an emptied class off the active list and clear its deficit; a debt is kept.
+     *
+     * @param index Index of the class that became empty.
+     */
+    void NotifyDrained(uint32_t index) override;
+
+    /**
+     * @brief Credit the quantum handed out on the way to the selected class, and rotate the
+     *        active list so that the selected class is at its head.
+     *
+     * @param index Index of the selected class.
+     */
+    void CommitSelection(uint32_t index) override;
+
+    /**
+     * @brief Allow the scheduler bypass in deficit mode only.
+     *
+     * @param index Index of the class the packet was classified into.
+     * @return true unless a surplus debt or a sequence position would have to be updated.
+     */
+    bool CanBypass(uint32_t index) const override;
 
     /**
      * @brief Get the next eligible traffic class index based on DRR scheduling.
      *
+     * Only computes the decision; deficits and the active list are updated by CommitSelection.
+     *
      * @return Index of the selected class, or -1 if all queues are empty or ineligible.
      */
     int32_t GetQueueForSchedule() const override;
+
+    /**
+     * @brief Check whether a class takes part in the round, e.g. in the weighted round robin
+     *        sequence. Subclasses serving some classes by other means exclude them.
+     *
+     * @param index Index of the class.
+     * @return true for every class unless a subclass overrides it.
+     */
+    virtual bool IsInRound(uint32_t index) const;
+
+    std::string m_configFile; // <- come from SetAttribute
+
+  private:
+    /**
+     * @brief Lay out the weighted round robin sequence for the current classes.
+     */
+    void BuildSequence();
+
+    /**
+     * @brief Get the first class that may send, starting at the current sequence position.
+     *
+     * O(1) while the class of the current slot may send, up to one round of slots otherwise.
+     *
+     * @return Index of the class, or -1 if no class may send.
+     */
+    int32_t SelectFromSequence() const;
+
+    /**
+     * @brief Get the allowance a class needs before it may send its head packet.
+     *
+     * @param index Index of the class.
+     * @return The head packet size, or in surplus mode one byte more than the class owes.
+     */
+    uint32_t GetNeededCredit(uint32_t index) const;
+
+    /**
+     * @brief Append a class to the tail of the active list.
+     *
+     * @param index Index of the class.
+     */
+    void PushActive(uint32_t index);
+
+    /**
+     * @brief Unlink a class from anywhere in the active list.
+     *
+     * @param index Index of the class.
+     */
+    void RemoveActive(uint32_t index);
+
+    Mode m_mode;                         //!< Deficit, surplus or weighted round robin
+    std::vector<uint32_t> m_debts;       //!< Bytes each class overdrew in surplus mode
+    std::vector<uint32_t> m_sequence;    //!< Weighted round robin service order of classes
+    uint32_t m_sequencePosition;         //!< Next position of m_sequence to serve
+    mutable uint32_t m_selectedPosition; //!< Position the last selection was made at
+
+    // Shreedhar-Varghese active list: only backlogged classes are linked, in service order
+    std::vector<int32_t> m_activeNext; //!< Next class on the active list, or -1
+    std::vector<int32_t> m_activePrev; //!< Previous class on the active list, or -1
+    std::vector<uint8_t> m_isActive;   //!< Whether each class is on the active list
+    int32_t m_activeHead;              //!< Class being visited, or -1 if the list is empty
+    int32_t m_activeTail;              //!< Last class on the active list, or -1
+    bool m_headCredited;               //!< The head class got its quantum for this visit
+    mutable uint32_t m_selectedRounds; //!< Full rounds of quantum the last selection needs
 };
 
 } // namespace ns3
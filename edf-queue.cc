@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "edf-queue.h"
+
+#include "qos-initializer.h"
+
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+
+NS_LOG_COMPONENT_DEFINE("EdfQueue");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(EdfQueue);
+
+// TypeId registration with ns-3
+TypeId
+EdfQueue::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::EdfQueue<Packet>")
+            .SetParent<DiffServ>()
+            .SetGroupName("Network")
+            .AddConstructor<EdfQueue>()
+            .AddAttribute("Config",
+                          "Path to EDF configuration file",
+                          StringValue(""),
+                          MakeStringAccessor(&EdfQueue::m_configFile),
+                          MakeStringChecker())
+            .AddAttribute("DropExpired",
+                          "Drop packets that are past their deadline when they are dequeued",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&EdfQueue::m_dropExpired),
+                          MakeBooleanChecker())
+            .AddAttribute("SlotWidth",
+                          "Deadline range sharing one calendar queue bucket",
+                          TimeValue(MicroSeconds(100)),
+                          MakeTimeAccessor(&EdfQueue::m_slotWidth),
+                          MakeTimeChecker());
+    return tid;
+}
+
+EdfQueue::EdfQueue()
+    : m_dropExpired(false)
+{
+}
+
+/**
+ * @brief Initializes the EDF queue using a JSON config file.
+ */
+void
+EdfQueue::DoInitialize()
+{
+    DiffServ::DoInitialize();
+    QosInitializer::InitializeEdfFromJson(this, m_configFile);
+}
+
+/**
+ * @brief Classify incoming packets based on filters in TrafficClass.
+ */
+int32_t
+EdfQueue::Classify(Ptr<Packet> p)
+{
+    return ClassifyByFilters(p);
+}
+
+/**
+ * @brief Add a traffic class. The head deadlines are recomputed and the miss counters cleared.
+ */
+void
+EdfQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
+{
+    DiffServ::AddTrafficClass(trafficClass);
+
+    uint32_t n = m_weights.size();
+    m_deadlines.assign(n, 0);
+    m_misses.assign(n, 0);
+    m_heads.Reset(n, m_slotWidth.GetNanoSeconds());
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (m_backlogs[i] > 0)
+            NotifyEnqueue(i);
+    }
+}
+
+/**
+ * @brief Schedules the next packet for transmission using EDF.
+ *
+ * A packet whose deadline has passed is counted as a miss; with DropExpired it is dropped and
+ * the next earliest deadline is tried.
+ *
+ * @return A pointer to the packet to be dequeued, or nullptr if all queues are empty.
+ */
+Ptr<Packet>
+EdfQueue::Schedule()
+{
+    double now = Simulator::Now().GetNanoSeconds();
+    while (true)
+    {
+        int scheduleIndex = SelectClass();
+
+        if (scheduleIndex == -1)
+        {
+            return nullptr;
+        }
+        CommitSelection(scheduleIndex);
+
+        bool late = m_deadlines[scheduleIndex] < now;
+        Ptr<Packet> p = DequeueFromClass(scheduleIndex);
+        if (!p)
+        {
+            continue; // a child scheduler dropped all it held, the class is now empty
+        }
+
+        if (!late)
+        {
+            return p;
+        }
+        m_misses[scheduleIndex]++;
+        if (!m_dropExpired)
+        {
+            return p;
+        }
+        NS_LOG_DEBUG("Dropping packet of class " << scheduleIndex << " past its deadline");
+        GetTrafficClasses()[scheduleIndex]->RecordDrop();
+        DropAfterDequeue(p);
+    }
+}
+
+/**
+ * @brief Each packet is checked against its deadline, so a burst is served packet by packet
+ *        through Schedule. A decision covers one head packet anyway, see GetBurstBytes. After
+ *        the first packet the burst stops at a late head, since dropping it would hand out a
+ *        packet the byte budget was not checked against.
+ *
+ * @param maxPackets Largest number of packets to return.
+ * @param maxBytes Byte budget; the first packet is returned even if it alone exceeds it.
+ * @return The dequeued packets, or an empty vector if no class may send.
+ */
+std::vector<Ptr<Packet>>
+EdfQueue::ScheduleBurst(uint32_t maxPackets, uint32_t maxBytes)
+{
+    double now = Simulator::Now().GetNanoSeconds();
+    std::vector<Ptr<Packet>> burst;
+    uint32_t bytes = 0;
+    while (burst.size() < maxPackets)
+    {
+        if (!burst.empty())
+        {
+            int32_t index = SelectClass();
+            if (index < 0 || m_deadlines[index] < now ||
+                m_headSizes[index] > maxBytes - std::min(maxBytes, bytes))
+            {
+                break;
+            }
+        }
+        Ptr<Packet> p = Schedule();
+        if (!p)
+        {
+            break;
+        }
+        bytes += p->GetSize();
+        burst.push_back(p);
+    }
+    return burst;
+}
+
+/**
+ * @brief The top of the calendar queue, unless it is out of tokens; then the backlogged
+ *        classes are scanned for the earliest deadline among those that may send.
+ */
+int32_t
+EdfQueue::GetQueueForSchedule() const
+{
+    int32_t top = m_heads.Top();
+    if (top < 0 || IsEligible(top))
+    {
+        return top;
+    }
+
+    int32_t selected = -1;
+    for (int32_t i = m_activeClasses.FindFirst(); i >= 0; i = m_activeClasses.FindNext(i))
+    {
+        if (IsEligible(i) && (selected < 0 || m_deadlines[i] < m_deadlines[selected]))
+            selected = i;
+    }
+    return selected;
+}
+
+/**
+ * @brief Only a class that was empty needs a deadline; otherwise its head packet is unchanged.
+ */
+void
+EdfQueue::NotifyEnqueue(uint32_t index)
+{
+    if (!m_heads.Contains(index))
+    {
+        UpdateDeadline(index);
+    }
+}
+
+/**
+ * @brief The deadline belongs to the head packet, so an empty class keeps nothing.
+ */
+void
+EdfQueue::NotifyDrained(uint32_t index)
+{
+    m_heads.Remove(index);
+}
+
+/**
+ * @brief Only the head packet carries the current deadline.
+ */
+uint32_t
+EdfQueue::GetBurstBytes(uint32_t index) const
+{
+    return m_headSizes[index];
+}
+
+/**
+ * @brief A still backlogged class files its next head packet.
+ */
+void
+EdfQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    if (m_backlogs[index] > 0)
+    {
+        UpdateDeadline(index);
+    }
+}
+
+uint64_t
+EdfQueue::GetDeadlineMisses(uint32_t index) const
+{
+    return m_misses.at(index);
+}
+
+void
+EdfQueue::UpdateDeadline(uint32_t index)
+{
+    Ptr<TrafficClass> tc = GetTrafficClasses()[index];
+    m_deadlines[index] = (tc->GetHeadEnqueueTime() + tc->GetDelayBudget()).GetNanoSeconds();
+    m_heads.Push(index, m_deadlines[index]);
+}
+
+} // namespace ns3
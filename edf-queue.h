@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef EDF_QUEUE_H
+#define EDF_QUEUE_H
+
+#include "calendar-queue.h"
+#include "diff-serv.h"
+
+namespace ns3
+{
+
+/**
+ * @brief A DiffServ-based class implementing Earliest Deadline First.
+ *
+ * Each packet's deadline is its arrival time plus the delay budget of its class, and the packet
+ * with the earliest deadline is served. Classes are FIFO, so only the head packet of each class
+ * is a candidate, and the head deadlines are kept in a calendar queue: O(1) per packet while
+ * the deadlines lie within the span of its wheel.
+ *
+ * A packet sent after its deadline counts as a deadline miss of its class. With DropExpired
+ * such a packet is dropped instead of being sent, which saves link time for packets that can
+ * still make it.
+ */
+class EdfQueue : public DiffServ
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Default constructor for EdfQueue.
+     */
+    EdfQueue();
+
+    /**
+     * @brief Schedule the next packet to dequeue using EDF, dropping expired packets on the way
+     *        if DropExpired is set.
+     *
+     * @return The next scheduled packet, or nullptr if no packets are available.
+     */
+    Ptr<Packet> Schedule() override;
+
+    /**
+     * @brief Classify a packet into one of the traffic classes.
+     *
+     * @param p The packet to classify.
+     * @return Index of the matching traffic class, or -1 if none match.
+     */
+    int32_t Classify(Ptr<Packet> p) override;
+
+    /**
+     * @brief Add a traffic class and reset the deadlines and miss counters.
+     *
+     * @param trafficClass Pointer to the TrafficClass to add.
+     */
+    void AddTrafficClass(Ptr<TrafficClass> trafficClass) override;
+
+    /**
+     * @brief Get how many packets of a class were sent, or dropped, after their deadline.
+     *
+     * @param index Index of the class.
+     * @return The number of deadline misses.
+     */
+    uint64_t GetDeadlineMisses(uint32_t index) const;
+
+  protected:
+    /**
+     * @brief Initialize the EDF queue from its JSON configuration.
+     */
+    void DoInitialize() override;
+
+    /**
+     * @brief File a class that just became backlogged under its head deadline.
+     *
+     * @param index Index of the class that received a packet.
+     */
+    void NotifyEnqueue(uint32_t index) override;
+
+    /**
+     * @brief Take an emptied class out of the calendar queue.
+     *
+     * @param index Index of the class that became empty.
+     */
+    void NotifyDrained(uint32_t index) override;
+
+    /**
+     * @brief A decision covers a single packet, whose deadline it was made on.
+     *
+     * @param index Index of the selected class.
+     * @return The head packet size of the class.
+     */
+    uint32_t GetBurstBytes(uint32_t index) const override;
+
+    /**
+     * @brief File the class that was served under the deadline of its next head packet.
+     *
+     * @param index Index of the class that was served.
+     * @param bytes Bytes sent.
+     */
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    /**
+     * @brief Dequeue packets one decision at a time, so that each is checked against its
+     *        deadline as Schedule does.
+     *
+     * @param maxPackets Largest number of packets to return.
+     * @param maxBytes Byte budget; the first packet is returned even if it alone exceeds it.
+     * @return The dequeued packets, or an empty vector if no class may send.
+     */
+    std::vector<Ptr<Packet>> ScheduleBurst(uint32_t maxPackets, uint32_t maxBytes) override;
+
+    /**
+     * @brief Get the backlogged class whose head packet has the earliest deadline.
+     *
+     * @return Index of the selected class, or -1 if all queues are empty or shaped.
+     */
+    int32_t GetQueueForSchedule() const override;
+
+  private:
+    /**
+     * @brief Compute the deadline of a class's head packet and file the class under it.
+     *
+     * @param index Index of a backlogged class.
+     */
+    void UpdateDeadline(uint32_t index);
+
+    std::string m_configFile; // <- come from SetAttribute
+
+    bool m_dropExpired;              //!< Drop packets past their deadline instead of sending them
+    Time m_slotWidth;                //!< Deadline range of one calendar queue bucket
+    std::vector<double> m_deadlines; //!< Deadline of each head packet in ns
+    std::vector<uint64_t> m_misses;  //!< Packets of each class sent or dropped past the deadline
+    CalendarQueue m_heads;           //!< Backlogged classes keyed by their head deadline
+};
+
+} // namespace ns3
+
+#endif // EDF_QUEUE_H
@@ -8,6 +8,8 @@
 
 #include "filter-class.h"
 
+#include "packet-parser.h"
+
 namespace ns3
 {
 // Register Filter as an ns-3 object with runtime type information
@@ -40,11 +42,19 @@ Filter::Filter()
  */
 bool
 Filter::Match(Ptr<Packet> p) const
+{
+    Ipv4Header header;
+    Ptr<Packet> payload;
+    return PacketParser::ParseIpv4(p, header, payload) && Match(header, payload);
+}
+
+bool
+Filter::Match(const Ipv4Header& header, Ptr<const Packet> payload) const
 {
     // NS_LOG_UNCOND("filters matching");
     for (Ptr<FilterElement> element : elements)
     {
-        if (!element->Match(p))
+        if (!element->Match(header, payload))
             return false;
     }
     return true;
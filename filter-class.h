@@ -48,6 +48,15 @@ class Filter : public Object
      */
     bool Match(ns3::Ptr<ns3::Packet> p) const;
 
+    /**
+     * @brief Check whether a packet whose headers are already parsed matches all conditions.
+     *
+     * @param header The IPv4 header of the packet.
+     * @param payload The packet behind the IPv4 header.
+     * @return true if all conditions are satisfied; false otherwise.
+     */
+    bool Match(const Ipv4Header& header, Ptr<const Packet> payload) const;
+
     /**
      * @brief Add a new FilterElement to this filter.
      *
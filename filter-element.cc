@@ -8,8 +8,9 @@
 
 #include "filter-element.h"
 
+#include "packet-parser.h"
+
 #include "ns3/log.h"
-#include "ns3/ppp-header.h"
 
 namespace ns3
 {
@@ -185,86 +186,55 @@ ProtocolNumber::ProtocolNumber()
 
 /* Method Implementations*/
 /**
- * @brief Match packets by exact source IP address.
+ * @brief Parse the packet once and match its headers.
  */
 bool
-SourceIpAddress::Match(Ptr<Packet> p) const
+FilterElement::Match(Ptr<Packet> p) const
 {
-    // Remove PPP header
-    Ptr<Packet> pCopy = p->Copy();
-    PppHeader pppHeader;
-    if (pCopy->RemoveHeader(pppHeader) == 0)
+    Ipv4Header header;
+    Ptr<Packet> payload;
+    if (!PacketParser::ParseIpv4(p, header, payload))
     {
-        NS_LOG_ERROR("Failed to remove PPP header from packet");
+        NS_LOG_ERROR("Failed to find an IPv4 header in packet");
         return false;
     }
+    return Match(header, payload);
+}
 
-    Ipv4Header header;
-    if (pCopy->PeekHeader(header))
-    {
-        // NS_LOG_UNCOND("IP address value: " << value);
-        // NS_LOG_UNCOND("IP address: " << header.GetSource());
-        return header.GetSource() == value;
-    }
-    return false;
+/**
+ * @brief Match packets by exact source IP address.
+ */
+bool
+SourceIpAddress::Match(const Ipv4Header& header, Ptr<const Packet> payload) const
+{
+    return header.GetSource() == value;
 }
 
 /**
  * @brief Match packets whose source IP falls within a given subnet.
  */
 bool
-SourceMask::Match(Ptr<Packet> p) const
+SourceMask::Match(const Ipv4Header& header, Ptr<const Packet> payload) const
 {
-    // Remove PPP header
-    Ptr<Packet> pCopy = p->Copy();
-    PppHeader pppHeader;
-    if (pCopy->RemoveHeader(pppHeader) == 0)
-    {
-        NS_LOG_ERROR("Failed to remove PPP header from packet");
-        return false;
-    }
-
-    Ipv4Header header;
-    if (pCopy->PeekHeader(header))
-    {
-        Ipv4Address src = header.GetSource();
-        return src.CombineMask(value) == addr.CombineMask(value);
-    }
-    return false;
+    Ipv4Address src = header.GetSource();
+    return src.CombineMask(value) == addr.CombineMask(value);
 }
 
 /**
  * @brief Match packets by source port number (UDP or TCP).
  */
 bool
-SourcePortNumber::Match(Ptr<Packet> p) const
+SourcePortNumber::Match(const Ipv4Header& header, Ptr<const Packet> payload) const
 {
-    // Remove PPP header and IP header
-    Ptr<Packet> pCopy = p->Copy();
-
-    PppHeader pppHeader;
-    Ipv4Header ipHeader;
-    if (pCopy->RemoveHeader(pppHeader) == 0)
-    {
-        NS_LOG_ERROR("Failed to remove PPP header from packet");
-        return false;
-    }
-    if (pCopy->RemoveHeader(ipHeader) == 0)
-    {
-        NS_LOG_ERROR("Failed to remove IP header from packet");
-        return false;
-    }
-
-    UdpHeader udp;
-    TcpHeader tcp;
-
-    if (pCopy->PeekHeader(udp))
+    if (header.GetProtocol() == UdpL4Protocol::PROT_NUMBER)
     {
-        return udp.GetSourcePort() == value;
+        UdpHeader udp;
+        return payload->PeekHeader(udp) && udp.GetSourcePort() == value;
     }
-    else if (pCopy->PeekHeader(tcp))
+    if (header.GetProtocol() == TcpL4Protocol::PROT_NUMBER)
     {
-        return tcp.GetSourcePort() == value;
+        TcpHeader tcp;
+        return payload->PeekHeader(tcp) && tcp.GetSourcePort() == value;
     }
     return false;
 }
@@ -273,83 +243,36 @@ SourcePortNumber::Match(Ptr<Packet> p) const
  * @brief Match packets by exact destination IP address.
  */
 bool
-DestinationIpAddress::Match(Ptr<Packet> p) const
+DestinationIpAddress::Match(const Ipv4Header& header, Ptr<const Packet> payload) const
 {
-    // Remove PPP header
-    Ptr<Packet> pCopy = p->Copy();
-    PppHeader pppHeader;
-    if (pCopy->RemoveHeader(pppHeader) == 0)
-    {
-        NS_LOG_ERROR("Failed to remove PPP header from packet");
-        return false;
-    }
-
-    Ipv4Header header;
-    if (pCopy->PeekHeader(header))
-    {
-        return header.GetDestination() == value;
-    }
-    return false;
+    return header.GetDestination() == value;
 }
 
 /**
  * @brief Match packets whose destination IP falls within a given subnet.
  */
 bool
-DestinationMask::Match(Ptr<Packet> p) const
+DestinationMask::Match(const Ipv4Header& header, Ptr<const Packet> payload) const
 {
-    // Remove PPP header
-    Ptr<Packet> pCopy = p->Copy();
-    PppHeader pppHeader;
-    if (pCopy->RemoveHeader(pppHeader) == 0)
-    {
-        NS_LOG_ERROR("Failed to remove PPP header from packet");
-        return false;
-    }
-
-    Ipv4Header header;
-    if (pCopy->PeekHeader(header))
-    {
-        Ipv4Address dst = header.GetDestination();
-        return dst.CombineMask(value) == addr.CombineMask(value);
-    }
-    return false;
+    Ipv4Address dst = header.GetDestination();
+    return dst.CombineMask(value) == addr.CombineMask(value);
 }
 
 /**
  * @brief Match packets by destination port number (UDP or TCP).
  */
 bool
-DestinationPortNumber::Match(Ptr<Packet> p) const
+DestinationPortNumber::Match(const Ipv4Header& header, Ptr<const Packet> payload) const
 {
-    // Remove PPP header and IP header
-    Ptr<Packet> pCopy = p->Copy();
-
-    PppHeader pppHeader;
-    Ipv4Header ipHeader;
-    if (pCopy->RemoveHeader(pppHeader) == 0)
+    if (header.GetProtocol() == UdpL4Protocol::PROT_NUMBER)
     {
-        NS_LOG_ERROR("Failed to remove PPP header from packet");
-        NS_LOG_UNCOND("Remove PPP header error");
-        return false;
+        UdpHeader udp;
+        return payload->PeekHeader(udp) && udp.GetDestinationPort() == value;
     }
-    if (pCopy->RemoveHeader(ipHeader) == 0)
+    if (header.GetProtocol() == TcpL4Protocol::PROT_NUMBER)
     {
-        NS_LOG_ERROR("Failed to remove IP header from packet");
-        NS_LOG_UNCOND("Remove Ip header error");
-        return false;
-    }
-
-    UdpHeader udp;
-    TcpHeader tcp;
-
-    if (pCopy->PeekHeader(udp))
-    {
-        return udp.GetDestinationPort() == value;
-    }
-    else if (pCopy->PeekHeader(tcp))
-    {
-        return tcp.GetDestinationPort() == value;
+        TcpHeader tcp;
+        return payload->PeekHeader(tcp) && tcp.GetDestinationPort() == value;
     }
     return false;
 }
@@ -358,23 +281,9 @@ DestinationPortNumber::Match(Ptr<Packet> p) const
  * @brief Match packets by IP protocol number (e.g., TCP=6, UDP=17).
  */
 bool
-ProtocolNumber::Match(Ptr<Packet> p) const
+ProtocolNumber::Match(const Ipv4Header& header, Ptr<const Packet> payload) const
 {
-    // Remove PPP header
-    Ptr<Packet> pCopy = p->Copy();
-    PppHeader pppHeader;
-    if (pCopy->RemoveHeader(pppHeader) == 0)
-    {
-        NS_LOG_ERROR("Failed to remove PPP header from packet");
-        return false;
-    }
-
-    Ipv4Header header;
-    if (pCopy->PeekHeader(header))
-    {
-        return header.GetProtocol() == value;
-    }
-    return false;
+    return header.GetProtocol() == value;
 }
 
 } // namespace ns3
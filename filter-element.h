@@ -31,10 +31,20 @@ class FilterElement : public Object
 
     /**
      * @brief Checks if a packet matches this filter element.
+     *
+     * The packet may be PPP-framed or start with its IPv4 header, see PacketParser.
      * @param p The packet to test.
      * @return true if the packet matches; false otherwise.
      */
-    virtual bool Match(ns3::Ptr<ns3::Packet> p) const = 0;
+    bool Match(ns3::Ptr<ns3::Packet> p) const;
+
+    /**
+     * @brief Checks if a packet whose headers are already parsed matches this filter element.
+     * @param header The IPv4 header of the packet.
+     * @param payload The packet behind the IPv4 header.
+     * @return true if the packet matches; false otherwise.
+     */
+    virtual bool Match(const Ipv4Header& header, Ptr<const Packet> payload) const = 0;
 };
 
 /**
@@ -50,7 +60,7 @@ class SourceIpAddress : public FilterElement
 
     SourceIpAddress();
 
-    bool Match(ns3::Ptr<ns3::Packet> p) const override;
+    bool Match(const Ipv4Header& header, Ptr<const Packet> payload) const override;
 };
 
 /**
@@ -67,7 +77,7 @@ class SourceMask : public FilterElement
 
     SourceMask();
 
-    bool Match(ns3::Ptr<ns3::Packet> p) const override;
+    bool Match(const Ipv4Header& header, Ptr<const Packet> payload) const override;
 };
 
 /**
@@ -83,7 +93,7 @@ class SourcePortNumber : public FilterElement
 
     SourcePortNumber();
 
-    bool Match(ns3::Ptr<ns3::Packet> p) const override;
+    bool Match(const Ipv4Header& header, Ptr<const Packet> payload) const override;
 };
 
 /**
@@ -99,7 +109,7 @@ class DestinationIpAddress : public FilterElement
 
     DestinationIpAddress();
 
-    bool Match(ns3::Ptr<ns3::Packet> p) const override;
+    bool Match(const Ipv4Header& header, Ptr<const Packet> payload) const override;
 };
 
 /**
@@ -116,7 +126,7 @@ class DestinationMask : public FilterElement
 
     DestinationMask();
 
-    bool Match(ns3::Ptr<ns3::Packet> p) const override;
+    bool Match(const Ipv4Header& header, Ptr<const Packet> payload) const override;
 };
 
 /**
@@ -132,7 +142,7 @@ class DestinationPortNumber : public FilterElement
 
     DestinationPortNumber();
 
-    bool Match(ns3::Ptr<ns3::Packet> p) const override;
+    bool Match(const Ipv4Header& header, Ptr<const Packet> payload) const override;
 };
 
 /**
@@ -148,7 +158,7 @@ class ProtocolNumber : public FilterElement
 
     ProtocolNumber();
 
-    bool Match(ns3::Ptr<ns3::Packet> p) const override;
+    bool Match(const Ipv4Header& header, Ptr<const Packet> payload) const override;
 };
 
 } // namespace ns3
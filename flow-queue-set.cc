@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "flow-queue-set.h"
+
+#include "packet-parser.h"
+
+#include "ns3/hash.h"
+#include "ns3/internet-module.h"
+#include "ns3/simulator.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace ns3
+{
+
+/** CoDel never drops while a flow holds at most this many bytes */
+static const uint32_t CODEL_MIN_BYTES = 1500;
+
+static uint32_t HashFlow(Ptr<const Packet> p);
+
+FlowQueueSet::FlowQueueSet()
+    : m_quantum(0),
+      m_useCodel(false),
+      m_packets(0)
+{
+}
+
+/**
+ * @brief Allocate the sub-queue table once; its size never changes afterwards.
+ */
+void
+FlowQueueSet::Configure(uint32_t flows,
+                        uint32_t quantum,
+                        bool useCodel,
+                        Time target,
+                        Time interval)
+{
+    m_flows.assign(flows, Flow());
+    m_newFlows = FlowList();
+    m_oldFlows = FlowList();
+    m_backlogs.Reset(flows);
+    m_quantum = quantum;
+    m_useCodel = useCodel;
+    m_target = target;
+    m_interval = interval;
+    m_packets = 0;
+}
+
+void
+FlowQueueSet::SetCongestionCallback(Callback<bool, Ptr<Packet>> cb)
+{
+    m_congestion = cb;
+}
+
+bool
+FlowQueueSet::IsEnabled() const
+{
+    return !m_flows.empty();
+}
+
+/**
+ * @brief Hash the packet to its sub-queue; a flow that was idle joins the new-flows list.
+ */
+void
+FlowQueueSet::Enqueue(const QueuedPacket& item)
+{
+    uint32_t index = HashFlow(item.packet) % m_flows.size();
+    Flow& flow = m_flows[index];
+
+    flow.packets.push_back(item);
+    flow.bytes += item.packet->GetSize();
+    m_packets++;
+    UpdateBacklog(index);
+
+    if (flow.status == INACTIVE)
+    {
+        flow.status = NEW_FLOW;
+        flow.deficit = m_quantum;
+        PushBack(m_newFlows, index);
+    }
+}
+
+Ptr<Packet>
+FlowQueueSet::Peek() const
+{
+    int32_t index = SelectFlow();
+    if (index < 0)
+    {
+        return nullptr;
+    }
+    return m_flows[index].packets.front().packet;
+}
+
+Time
+FlowQueueSet::GetHeadEnqueueTime() const
+{
+    int32_t index = SelectFlow();
+    if (index < 0)
+    {
+        return Time(0);
+    }
+    return m_flows[index].packets.front().enqueueTime;
+}
+
+/**
+ * @brief Serve the selected flow, passing its head packets through CoDel first.
+ */
+bool
+FlowQueueSet::Dequeue(QueuedPacket& item)
+{
+    int32_t index = AdvanceFlows();
+    if (index < 0)
+    {
+        return false;
+    }
+
+    Flow& flow = m_flows[index];
+    Time now = Simulator::Now();
+    while (true)
+    {
+        item = flow.packets.front();
+        flow.packets.pop_front();
+        flow.bytes -= item.packet->GetSize();
+        m_packets--;
+
+        // A marked packet is delivered, a dropped one is replaced by the next head
+        if (!m_useCodel || !CodelShouldDrop(flow, item, now) || m_congestion(item.packet))
+        {
+            break;
+        }
+    }
+
+    flow.deficit -= item.packet->GetSize();
+    UpdateBacklog(index);
+    return true;
+}
+
+/**
+ * @brief Drop from the fattest flow, which is the top of the backlog heap.
+ */
+bool
+FlowQueueSet::DropTail(QueuedPacket& item)
+{
+    int32_t fattest = m_backlogs.Top();
+    if (fattest < 0)
+    {
+        return false;
+    }
+
+    Flow& flow = m_flows[fattest];
+    item = flow.packets.back();
+    flow.packets.pop_back();
+    flow.bytes -= item.packet->GetSize();
+    m_packets--;
+    UpdateBacklog(fattest);
+    return true;
+}
+
+uint32_t
+FlowQueueSet::GetPackets() const
+{
+    return m_packets;
+}
+
+/**
+ * @brief Replay AdvanceFlows without moving anything. A backlogged flow with deficit left is
+ *        served on the first pass, in new-then-old list order. Otherwise every backlogged
+ *        flow earns one quantum per pass and keeps its relative order, so the flow that turns
+ *        positive in the fewest passes wins, the earliest in list order on a tie.
+ */
+int32_t
+FlowQueueSet::SelectFlow() const
+{
+    int32_t selected = -1;
+    int32_t selectedPasses = 0;
+    for (const FlowList* list : {&m_newFlows, &m_oldFlows})
+    {
+        for (int32_t i = list->head; i != -1; i = m_flows[i].next)
+        {
+            const Flow& flow = m_flows[i];
+            if (flow.packets.empty())
+            {
+                continue;
+            }
+            if (flow.deficit > 0)
+            {
+                return i;
+            }
+            int32_t passes = -flow.deficit / static_cast<int32_t>(m_quantum) + 1;
+            if (selected < 0 || passes < selectedPasses)
+            {
+                selected = i;
+                selectedPasses = passes;
+            }
+        }
+    }
+    return selected;
+}
+
+/**
+ * @brief FQ-CoDel flow rotation: a head flow out of deficit earns a quantum and moves to the
+ *        tail of the old list; an empty new flow moves to the old list so it cannot starve old
+ *        flows, and an empty old flow becomes inactive.
+ */
+int32_t
+FlowQueueSet::AdvanceFlows()
+{
+    while (true)
+    {
+        bool fromNew = m_newFlows.head != -1;
+        FlowList& list = fromNew ? m_newFlows : m_oldFlows;
+        int32_t index = list.head;
+        if (index == -1)
+        {
+            return -1;
+        }
+
+        Flow& flow = m_flows[index];
+        if (flow.deficit <= 0)
+        {
+            flow.deficit += m_quantum;
+            PopFront(list);
+            flow.status = OLD_FLOW;
+            PushBack(m_oldFlows, index);
+            continue;
+        }
+
+        if (flow.packets.empty())
+        {
+            PopFront(list);
+            if (fromNew)
+            {
+                flow.status = OLD_FLOW;
+                PushBack(m_oldFlows, index);
+            }
+            else
+            {
+                flow.status = INACTIVE;
+            }
+            continue;
+        }
+
+        return index;
+    }
+}
+
+void
+FlowQueueSet::PushBack(FlowList& list, uint32_t index)
+{
+    m_flows[index].next = -1;
+    if (list.tail == -1)
+    {
+        list.head = index;
+    }
+    else
+    {
+        m_flows[list.tail].next = index;
+    }
+    list.tail = index;
+}
+
+void
+FlowQueueSet::PopFront(FlowList& list)
+{
+    int32_t index = list.head;
+    list.head = m_flows[index].next;
+    if (list.head == -1)
+    {
+        list.tail = -1;
+    }
+    m_flows[index].next = -1;
+}
+
+/**
+ * @brief CoDel (RFC 8289) drop decision for a packet that has just left the flow.
+ *
+ * The sojourn time must stay above target for a whole interval before the first drop; while
+ * dropping, drops are spaced by interval / sqrt(count).
+ */
+bool
+FlowQueueSet::CodelShouldDrop(Flow& flow, const QueuedPacket& item, Time now)
+{
+    bool okToDrop = false;
+    if (now - item.enqueueTime < m_target || flow.bytes <= CODEL_MIN_BYTES)
+    {
+        flow.firstAboveTime = Time(0);
+    }
+    else if (flow.firstAboveTime.IsZero())
+    {
+        flow.firstAboveTime = now + m_interval;
+    }
+    else
+    {
+        okToDrop = now >= flow.firstAboveTime;
+    }
+
+    if (flow.dropping)
+    {
+        if (!okToDrop)
+        {
+            flow.dropping = false;
+            return false;
+        }
+        if (now < flow.dropNext)
+        {
+            return false;
+        }
+        flow.count++;
+        flow.dropNext = flow.dropNext + Seconds(m_interval.GetSeconds() / std::sqrt(flow.count));
+        return true;
+    }
+
+    if (!okToDrop)
+    {
+        return false;
+    }
+
+    // Resume near the previous drop rate if the last dropping state ended recently
+    uint32_t delta = flow.count - flow.lastCount;
+    bool recent = now - flow.dropNext < m_interval * 16;
+    flow.count = (delta > 1 && recent) ? delta : 1;
+    flow.lastCount = flow.count;
+    flow.dropping = true;
+    flow.dropNext = now + Seconds(m_interval.GetSeconds() / std::sqrt(flow.count));
+    return true;
+}
+
+/**
+ * @brief The heap is a min-heap, so the key is the negated byte count; empty flows leave it.
+ */
+void
+FlowQueueSet::UpdateBacklog(uint32_t index)
+{
+    if (m_flows[index].packets.empty())
+    {
+        m_backlogs.Remove(index);
+    }
+    else
+    {
+        m_backlogs.Push(index, -static_cast<double>(m_flows[index].bytes));
+    }
+}
+
+/**
+ * @brief Hash the IPv4 5-tuple of a packet; packets without one share flow 0.
+ */
+static uint32_t
+HashFlow(Ptr<const Packet> p)
+{
+    Ptr<Packet> pCopy;
+    Ipv4Header ipHeader;
+    if (!PacketParser::ParseIpv4(p, ipHeader, pCopy))
+    {
+        return 0;
+    }
+
+    uint16_t srcPort = 0;
+    uint16_t dstPort = 0;
+    if (ipHeader.GetProtocol() == UdpL4Protocol::PROT_NUMBER)
+    {
+        UdpHeader udp;
+        if (pCopy->PeekHeader(udp))
+        {
+            srcPort = udp.GetSourcePort();
+            dstPort = udp.GetDestinationPort();
+        }
+    }
+    else if (ipHeader.GetProtocol() == TcpL4Protocol::PROT_NUMBER)
+    {
+        TcpHeader tcp;
+        if (pCopy->PeekHeader(tcp))
+        {
+            srcPort = tcp.GetSourcePort();
+            dstPort = tcp.GetDestinationPort();
+        }
+    }
+
+    uint8_t buf[13];
+    uint32_t src = ipHeader.GetSource().Get();
+    uint32_t dst = ipHeader.GetDestination().Get();
+    std::memcpy(buf, &src, 4);
+    std::memcpy(buf + 4, &dst, 4);
+    buf[8] = ipHeader.GetProtocol();
+    std::memcpy(buf + 9, &srcPort, 2);
+    std::memcpy(buf + 11, &dstPort, 2);
+    return Hash32(reinterpret_cast<const char*>(buf), sizeof(buf));
+}
+
+} // namespace ns3
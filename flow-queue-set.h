@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef FLOW_QUEUE_SET_H
+#define FLOW_QUEUE_SET_H
+
+#include "indexed-heap.h"
+
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+
+#include <deque>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief A packet waiting in a traffic class, stamped with its arrival time.
+ */
+struct QueuedPacket
+{
+    Ptr<Packet> packet; //!< The packet waiting to be scheduled
+    Time enqueueTime;   //!< Arrival time, used to measure the sojourn time
+};
+
+/**
+ * @brief Per-flow fair queuing (FQ-CoDel style) used inside a single TrafficClass.
+ *
+ * Flows are hashed into a fixed table of sub-queues. Backlogged sub-queues sit on a "new" or an
+ * "old" list and are served deficit round robin, new flows first. Each sub-queue can optionally
+ * run CoDel on its head packets. Only flows with packets are visited, so Enqueue, Peek and
+ * Dequeue are O(1) regardless of the table size while the head flow has deficit left. Peek
+ * never reorders the flows; the lists only rotate when a packet is dequeued.
+ */
+class FlowQueueSet
+{
+  public:
+    FlowQueueSet();
+
+    /**
+     * @brief Allocate the sub-queue table and set the scheduling parameters.
+     *
+     * @param flows Number of sub-queues; zero leaves the set disabled.
+     * @param quantum Bytes a flow may send per round.
+     * @param useCodel Whether to run CoDel on every sub-queue.
+     * @param target CoDel target sojourn time.
+     * @param interval CoDel interval.
+     */
+    void Configure(uint32_t flows, uint32_t quantum, bool useCodel, Time target, Time interval);
+
+    /**
+     * @brief Set the callback applied to packets CoDel decides to drop.
+     *
+     * The callback returns true if it CE-marked the packet, which is then still delivered.
+     *
+     * @param cb The congestion callback.
+     */
+    void SetCongestionCallback(Callback<bool, Ptr<Packet>> cb);
+
+    /**
+     * @brief Check whether the flow queue mode is configured.
+     *
+     * @return true if the set holds at least one sub-queue.
+     */
+    bool IsEnabled() const;
+
+    /**
+     * @brief Add a packet to the sub-queue of its flow.
+     *
+     * @param item The packet and its arrival time.
+     */
+    void Enqueue(const QueuedPacket& item);
+
+    /**
+     * @brief Get the head packet of the flow that is served next.
+     *
+     * @return The packet, or nullptr if the set is empty.
+     */
+    Ptr<Packet> Peek() const;
+
+    /**
+     * @brief Get the arrival time of the packet Peek returns.
+     *
+     * @return The arrival time, or zero if the set is empty.
+     */
+    Time GetHeadEnqueueTime() const;
+
+    /**
+     * @brief Remove the next packet, letting CoDel drop heads of the served flow first.
+     *
+     * CoDel never drops the last MTU worth of a flow, so a packet is returned whenever the set
+     * is not empty.
+     *
+     * @param item Receives the dequeued packet and its arrival time.
+     * @return true if a packet was dequeued.
+     */
+    bool Dequeue(QueuedPacket& item);
+
+    /**
+     * @brief Remove the most recent packet of the flow holding the most bytes.
+     *
+     * The flow is found in O(log n) through a heap of the backlogged sub-queues.
+     *
+     * @param item Receives the removed packet and its arrival time.
+     * @return true if a packet was removed.
+     */
+    bool DropTail(QueuedPacket& item);
+
+    /**
+     * @brief Get the number of packets held by all sub-queues.
+     *
+     * @return The packet count.
+     */
+    uint32_t GetPackets() const;
+
+  private:
+    /**
+     * @brief Which scheduling list a sub-queue is on.
+     */
+    enum FlowStatus
+    {
+        INACTIVE, //!< Not on any list
+        NEW_FLOW, //!< On the new-flows list
+        OLD_FLOW, //!< On the old-flows list
+    };
+
+    /**
+     * @brief One sub-queue and its DRR and CoDel state.
+     */
+    struct Flow
+    {
+        std::deque<QueuedPacket> packets; //!< Packets of the flows hashed here
+        uint32_t bytes{0};                //!< Bytes held by this sub-queue
+        int32_t deficit{0};               //!< DRR deficit in bytes
+        FlowStatus status{INACTIVE};      //!< List membership
+        int32_t next{-1};                 //!< Next sub-queue on the same list
+        bool dropping{false};             //!< CoDel is in the dropping state
+        uint32_t count{0};                //!< CoDel drops in the current dropping state
+        uint32_t lastCount{0};            //!< CoDel count when the last dropping state started
+        Time firstAboveTime;              //!< When the sojourn time will have been above target
+        Time dropNext;                    //!< Next CoDel drop time while dropping
+    };
+
+    /**
+     * @brief Head and tail of an intrusive FIFO list of sub-queues.
+     */
+    struct FlowList
+    {
+        int32_t head{-1}; //!< First sub-queue, or -1
+        int32_t tail{-1}; //!< Last sub-queue, or -1
+    };
+
+    /**
+     * @brief Find the flow the next Dequeue serves, without touching the lists.
+     *
+     * @return Index of the flow to serve, or -1 if all sub-queues are empty.
+     */
+    int32_t SelectFlow() const;
+
+    /**
+     * @brief Rotate the lists until the head flow has both packets and deficit left.
+     *
+     * Only Dequeue calls this; it ends on the flow SelectFlow returns.
+     *
+     * @return Index of the flow to serve, or -1 if all sub-queues are empty.
+     */
+    int32_t AdvanceFlows();
+
+    /**
+     * @brief Append a sub-queue to a list.
+     *
+     * @param list The list.
+     * @param index Index of the sub-queue.
+     */
+    void PushBack(FlowList& list, uint32_t index);
+
+    /**
+     * @brief Remove the first sub-queue of a list.
+     *
+     * @param list The list.
+     */
+    void PopFront(FlowList& list);
+
+    /**
+     * @brief Run the CoDel state machine on a packet just removed from a flow.
+     *
+     * @param flow The sub-queue the packet came from.
+     * @param item The removed packet.
+     * @param now The current time.
+     * @return true if CoDel wants the packet dropped (or marked).
+     */
+    bool CodelShouldDrop(Flow& flow, const QueuedPacket& item, Time now);
+
+    /**
+     * @brief Re-key a sub-queue in the backlog heap after its byte count changed.
+     *
+     * @param index Index of the sub-queue.
+     */
+    void UpdateBacklog(uint32_t index);
+
+    std::vector<Flow> m_flows;                //!< Fixed sub-queue table
+    FlowList m_newFlows;                      //!< Flows that recently became backlogged
+    FlowList m_oldFlows;                      //!< Flows that used up their first quantum
+    IndexedHeap m_backlogs;                   //!< Backlogged sub-queues keyed by -bytes
+    uint32_t m_quantum;                       //!< Bytes a flow may send per round
+    bool m_useCodel;                          //!< Whether CoDel runs on the sub-queues
+    Time m_target;                            //!< CoDel target sojourn time
+    Time m_interval;                          //!< CoDel interval
+    uint32_t m_packets;                       //!< Packets held by all sub-queues
+    Callback<bool, Ptr<Packet>> m_congestion; //!< Marks or drops CoDel victims
+};
+
+} // namespace ns3
+
+#endif // FLOW_QUEUE_SET_H
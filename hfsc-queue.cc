@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "hfsc-queue.h"
+
+#include "qos-initializer.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("HfscQueue");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(HfscQueue);
+
+// TypeId registration with ns-3
+TypeId
+HfscQueue::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::HfscQueue<Packet>")
+                            .SetParent<DiffServ>()
+                            .SetGroupName("Network")
+                            .AddConstructor<HfscQueue>()
+                            .AddAttribute("Config",
+                                          "Path to HFSC configuration file",
+                                          StringValue(""),
+                                          MakeStringAccessor(&HfscQueue::m_configFile),
+                                          MakeStringChecker());
+    return tid;
+}
+
+HfscQueue::HfscQueue()
+    : m_systemVirtualTime(0),
+      m_maxVirtualTime(0),
+      m_realTimeSelected(false)
+{
+}
+
+/**
+ * @brief Initializes the HFSC queue using a JSON config file.
+ */
+void
+HfscQueue::DoInitialize()
+{
+    DiffServ::DoInitialize();
+    QosInitializer::InitializeHfscFromJson(this, m_configFile);
+}
+
+/**
+ * @brief Classify incoming packets based on filters in TrafficClass.
+ */
+int32_t
+HfscQueue::Classify(Ptr<Packet> p)
+{
+    return ClassifyByFilters(p);
+}
+
+/**
+ * @brief Add a traffic class. Every class starts over with fresh curves; a class without a
+ *        link-sharing curve shares in proportion to its weight.
+ */
+void
+HfscQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
+{
+    DiffServ::AddTrafficClass(trafficClass);
+
+    const auto& q_class = GetTrafficClasses();
+    uint32_t n = q_class.size();
+    m_deadlineCurves.resize(n);
+    m_eligibleCurves.resize(n);
+    m_virtualCurves.resize(n);
+    m_realTime.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_deadlineCurves[i] = q_class[i]->GetRealTimeCurve();
+        m_eligibleCurves[i] = m_deadlineCurves[i];
+        m_realTime[i] = !m_deadlineCurves[i].IsZero();
+
+        m_virtualCurves[i] = q_class[i]->GetLinkShareCurve();
+        if (m_virtualCurves[i].IsZero())
+        {
+            DataRate share(uint64_t(m_weights[i]) * 8);
+            m_virtualCurves[i] = ServiceCurve(DataRate(0), Time(0), share);
+        }
+    }
+
+    m_cumul.assign(n, 0);
+    m_total.assign(n, 0);
+    m_eligible.assign(n, 0);
+    m_deadline.assign(n, 0);
+    m_virtual.assign(n, 0);
+    m_waitingRealTime.Reset(n);
+    m_eligibleRealTime.Reset(n);
+    m_linkShare.Reset(n);
+    m_systemVirtualTime = 0;
+    m_maxVirtualTime = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (m_backlogs[i] > 0)
+            NotifyEnqueue(i);
+    }
+}
+
+/**
+ * @brief Schedules the next packet for transmission using HFSC.
+ * @return A pointer to the packet to be dequeued, or nullptr if all queues are empty.
+ */
+Ptr<Packet>
+HfscQueue::Schedule()
+{
+    return ServeSelection();
+}
+
+/**
+ * @brief The real-time criterion first, link sharing with whatever capacity it leaves.
+ */
+int32_t
+HfscQueue::GetQueueForSchedule() const
+{
+    int32_t selected = SelectRealTime();
+    m_realTimeSelected = selected >= 0;
+    return m_realTimeSelected ? selected : SelectLinkShare();
+}
+
+/**
+ * @brief The top of the deadline heap, unless it is out of tokens; then that heap is scanned.
+ *        Classes whose eligible time passed since the heaps were last updated are still in the
+ *        waiting heap; only its entries that are due are visited, which the heap order bounds.
+ */
+int32_t
+HfscQueue::SelectRealTime() const
+{
+    int32_t selected = m_eligibleRealTime.Top();
+    if (selected >= 0 && !IsEligible(selected))
+    {
+        selected = -1;
+        for (uint32_t position = 0; position < m_eligibleRealTime.GetSize(); ++position)
+        {
+            uint32_t i = m_eligibleRealTime.GetAt(position);
+            if (IsEligible(i) && (selected < 0 || m_deadline[i] < m_deadline[selected]))
+                selected = i;
+        }
+    }
+
+    double now = Simulator::Now().GetSeconds();
+    if (m_waitingRealTime.GetSize() == 0 || m_waitingRealTime.TopKey() > now)
+    {
+        return selected;
+    }
+
+    std::vector<uint32_t> positions = {0};
+    while (!positions.empty())
+    {
+        uint32_t position = positions.back();
+        positions.pop_back();
+        if (position >= m_waitingRealTime.GetSize())
+            continue;
+
+        uint32_t i = m_waitingRealTime.GetAt(position);
+        if (m_waitingRealTime.GetKey(i) > now)
+            continue; // neither is anything below it in the heap
+
+        if (IsEligible(i) && (selected < 0 || m_deadline[i] < m_deadline[selected]))
+            selected = i;
+        positions.push_back(2 * position + 1);
+        positions.push_back(2 * position + 2);
+    }
+    return selected;
+}
+
+/**
+ * @brief The top of the virtual time heap, unless it is out of tokens; then the heap is scanned
+ *        for the smallest virtual time among the classes that may send.
+ */
+int32_t
+HfscQueue::SelectLinkShare() const
+{
+    int32_t top = m_linkShare.Top();
+    if (top < 0 || IsEligible(top))
+    {
+        return top;
+    }
+
+    int32_t selected = -1;
+    for (uint32_t position = 0; position < m_linkShare.GetSize(); ++position)
+    {
+        uint32_t i = m_linkShare.GetAt(position);
+        if (IsEligible(i) && (selected < 0 || m_virtual[i] < m_virtual[selected]))
+            selected = i;
+    }
+    return selected;
+}
+
+/**
+ * @brief Move every class whose eligible time has passed into the deadline heap.
+ */
+void
+HfscQueue::CommitSelection(uint32_t index)
+{
+    double now = Simulator::Now().GetSeconds();
+    while (m_waitingRealTime.GetSize() > 0 && m_waitingRealTime.TopKey() <= now)
+    {
+        uint32_t i = m_waitingRealTime.Top();
+        m_waitingRealTime.Remove(i);
+        m_eligibleRealTime.Push(i, m_deadline[i]);
+    }
+}
+
+/**
+ * @brief A class becoming backlogged restarts its deadline curve at the current time and its
+ *        real-time service so far, unless the curve it is on is already lower. The eligible
+ *        curve follows the deadline curve, except that for a convex curve it is the second
+ *        segment alone, so that the class becomes eligible early enough to meet the steep part.
+ *        The virtual curve restarts at the later of the class's own virtual time and the system
+ *        virtual time, as in start-time fair queueing.
+ */
+void
+HfscQueue::NotifyEnqueue(uint32_t index)
+{
+    if (m_linkShare.Contains(index))
+    {
+        return; // already backlogged, the head packet is unchanged
+    }
+
+    double now = Simulator::Now().GetSeconds();
+    if (m_realTime[index])
+    {
+        m_deadlineCurves[index].Min(now, m_cumul[index]);
+        m_eligibleCurves[index] = m_deadlineCurves[index];
+        if (!m_eligibleCurves[index].IsConcave())
+        {
+            m_eligibleCurves[index].DropFirstSegment();
+        }
+        UpdateRealTime(index);
+    }
+
+    double vt = std::max(m_virtual[index], m_systemVirtualTime);
+    m_virtualCurves[index].Min(vt, m_total[index]);
+    m_virtual[index] = m_virtualCurves[index].GetX(m_total[index]);
+    m_linkShare.Push(index, m_virtual[index]);
+}
+
+/**
+ * @brief Remove an emptied class from the heaps. When no class is left, the next busy period
+ *        starts at the largest virtual time reached.
+ */
+void
+HfscQueue::NotifyDrained(uint32_t index)
+{
+    m_waitingRealTime.Remove(index);
+    m_eligibleRealTime.Remove(index);
+    m_linkShare.Remove(index);
+    if (m_linkShare.GetSize() == 0)
+    {
+        m_systemVirtualTime = m_maxVirtualTime;
+    }
+}
+
+/**
+ * @brief Only the head packet is covered by the current deadline.
+ */
+uint32_t
+HfscQueue::GetBurstBytes(uint32_t index) const
+{
+    return m_headSizes[index];
+}
+
+/**
+ * @brief Real-time service counts against the deadline curve, any service against the virtual
+ *        curve. A still backlogged class gets a new deadline for its next packet, and a new
+ *        eligible time if the real-time criterion served it.
+ */
+void
+HfscQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    if (m_realTimeSelected)
+    {
+        m_cumul[index] += bytes;
+    }
+    else
+    {
+        m_systemVirtualTime = m_virtual[index];
+    }
+
+    m_total[index] += bytes;
+    m_virtual[index] = m_virtualCurves[index].GetX(m_total[index]);
+    m_maxVirtualTime = std::max(m_maxVirtualTime, m_virtual[index]);
+
+    if (m_backlogs[index] > 0)
+    {
+        if (m_realTime[index])
+        {
+            UpdateRealTime(index);
+        }
+        m_linkShare.Push(index, m_virtual[index]);
+    }
+    else if (m_linkShare.GetSize() == 0)
+    {
+        m_systemVirtualTime = m_maxVirtualTime; // the queue just went idle
+    }
+}
+
+/**
+ * @brief The eligible time is when the eligible curve reaches the real-time service so far,
+ *        the deadline when the deadline curve covers the head packet as well.
+ */
+void
+HfscQueue::UpdateRealTime(uint32_t index)
+{
+    m_eligible[index] = m_eligibleCurves[index].GetX(m_cumul[index]);
+    m_deadline[index] = m_deadlineCurves[index].GetX(m_cumul[index] + m_headSizes[index]);
+
+    m_waitingRealTime.Remove(index);
+    m_eligibleRealTime.Remove(index);
+    if (m_eligible[index] <= Simulator::Now().GetSeconds())
+    {
+        m_eligibleRealTime.Push(index, m_deadline[index]);
+    }
+    else
+    {
+        m_waitingRealTime.Push(index, m_eligible[index]);
+    }
+}
+
+} // namespace ns3
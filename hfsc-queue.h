@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef HFSC_QUEUE_H
+#define HFSC_QUEUE_H
+
+#include "diff-serv.h"
+#include "indexed-heap.h"
+#include "service-curve.h"
+
+namespace ns3
+{
+
+/**
+ * @brief A DiffServ-based class implementing the Hierarchical Fair Service Curve scheduler.
+ *
+ * Each class may have a real-time service curve, which bounds its delay, and a link-sharing
+ * curve, which sets its share of the bandwidth left over; a concave real-time curve gives a
+ * class a low delay without a high long-term rate. The real-time criterion comes first: among
+ * the classes whose eligible time has passed, the one with the earliest deadline is served.
+ * Otherwise the backlogged class with the smallest virtual time is served, virtual time
+ * advancing along the link-sharing curve.
+ *
+ * Eligible and deadline times are tracked in two heaps (classes waiting to become eligible by
+ * eligible time, eligible classes by deadline) and virtual times in a third, so each packet
+ * costs O(log n).
+ */
+class HfscQueue : public DiffServ
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Default constructor for HfscQueue.
+     */
+    HfscQueue();
+
+    /**
+     * @brief Schedule the next packet to dequeue using HFSC.
+     *
+     * @return The next scheduled packet, or nullptr if no packets are available.
+     */
+    Ptr<Packet> Schedule() override;
+
+    /**
+     * @brief Classify a packet into one of the traffic classes.
+     *
+     * @param p The packet to classify.
+     * @return Index of the matching traffic class, or -1 if none match.
+     */
+    int32_t Classify(Ptr<Packet> p) override;
+
+    /**
+     * @brief Add a traffic class and reset the curves of every class.
+     *
+     * @param trafficClass Pointer to the TrafficClass to add.
+     */
+    void AddTrafficClass(Ptr<TrafficClass> trafficClass) override;
+
+  protected:
+    /**
+     * @brief Initialize the HFSC queue from its JSON configuration.
+     */
+    void DoInitialize() override;
+
+    /**
+     * @brief Restart the curves of a class that just became backlogged.
+     *
+     * @param index Index of the class that received a packet.
+     */
+    void NotifyEnqueue(uint32_t index) override;
+
+    /**
+     * @brief Take an emptied class out of the heaps.
+     *
+     * @param index Index of the class that became empty.
+     */
+    void NotifyDrained(uint32_t index) override;
+
+    /**
+     * @brief Move the classes whose eligible time has passed to the deadline heap.
+     *
+     * @param index Index of the selected class.
+     */
+    void CommitSelection(uint32_t index) override;
+
+    /**
+     * @brief A decision covers a single packet, whose size the deadline was computed for.
+     *
+     * @param index Index of the selected class.
+     * @return The head packet size of the class.
+     */
+    uint32_t GetBurstBytes(uint32_t index) const override;
+
+    /**
+     * @brief Account the bytes sent to the criterion that selected the class and recompute its
+     *        eligible time, deadline and virtual time.
+     *
+     * @param index Index of the class.
+     * @param bytes Bytes sent.
+     */
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    /**
+     * @brief Get the class HFSC serves next.
+     *
+     * @return Index of the selected class, or -1 if all queues are empty or shaped.
+     */
+    int32_t GetQueueForSchedule() const override;
+
+  private:
+    /**
+     * @brief Get the eligible class with the earliest deadline.
+     *
+     * @return Index of the class, or -1 if no class is eligible under its real-time curve.
+     */
+    int32_t SelectRealTime() const;
+
+    /**
+     * @brief Get the backlogged class with the smallest virtual time.
+     *
+     * @return Index of the class, or -1 if no class may send.
+     */
+    int32_t SelectLinkShare() const;
+
+    /**
+     * @brief Compute the eligible time and deadline of a class's head packet and file the class
+     *        in the matching real-time heap.
+     *
+     * @param index Index of the class.
+     */
+    void UpdateRealTime(uint32_t index);
+
+    std::string m_configFile; // <- come from SetAttribute
+
+    std::vector<ServiceCurve> m_deadlineCurves; //!< Real-time deadline curve of each class
+    std::vector<ServiceCurve> m_eligibleCurves; //!< Real-time eligible curve of each class
+    std::vector<ServiceCurve> m_virtualCurves;  //!< Link-sharing curve in virtual time
+    std::vector<uint8_t> m_realTime;            //!< Whether each class has a real-time curve
+    std::vector<double> m_cumul;                //!< Bytes sent under the real-time criterion
+    std::vector<double> m_total;                //!< Bytes sent under either criterion
+    std::vector<double> m_eligible;             //!< Eligible time of each head packet in s
+    std::vector<double> m_deadline;             //!< Deadline of each head packet in s
+    std::vector<double> m_virtual;              //!< Virtual time of each class
+    IndexedHeap m_waitingRealTime;              //!< Not yet eligible classes by eligible time
+    IndexedHeap m_eligibleRealTime;             //!< Eligible classes by deadline
+    IndexedHeap m_linkShare;                    //!< Backlogged classes by virtual time
+    double m_systemVirtualTime;                 //!< Virtual time of the last link-sharing pick
+    double m_maxVirtualTime;                    //!< Largest virtual time reached so far
+    mutable bool m_realTimeSelected;            //!< The last selection used the real-time rule
+};
+
+} // namespace ns3
+
+#endif // HFSC_QUEUE_H
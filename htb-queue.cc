@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "htb-queue.h"
+
+#include "qos-initializer.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("HtbQueue");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(HtbQueue);
+
+// TypeId registration with ns-3
+TypeId
+HtbQueue::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::HtbQueue<Packet>")
+                            .SetParent<DiffServ>()
+                            .SetGroupName("Network")
+                            .AddConstructor<HtbQueue>()
+                            .AddAttribute("Config",
+                                          "Path to HTB configuration file",
+                                          StringValue(""),
+                                          MakeStringAccessor(&HtbQueue::m_configFile),
+                                          MakeStringChecker());
+    return tid;
+}
+
+HtbQueue::HtbQueue()
+{
+}
+
+/**
+ * @brief Initializes the HTB queue, and the schedulers of its nested classes, from JSON.
+ */
+void
+HtbQueue::DoInitialize()
+{
+    DiffServ::DoInitialize();
+    QosInitializer::InitializeHtbFromJson(this, m_configFile);
+}
+
+/**
+ * @brief Classify incoming packets based on filters in TrafficClass.
+ */
+int32_t
+HtbQueue::Classify(Ptr<Packet> p)
+{
+    return ClassifyByFilters(p);
+}
+
+/**
+ * @brief Add a traffic class. Classes are sorted by descending priority, keeping the
+ *        configuration order within a priority level, and the level groups, turns and colors
+ *        are rebuilt.
+ */
+void
+HtbQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
+{
+    DiffServ::AddTrafficClass(trafficClass);
+
+    auto& q_class = GetTrafficClasses();
+    std::stable_sort(q_class.begin(),
+                     q_class.end(),
+                     [](const Ptr<TrafficClass> a, const Ptr<TrafficClass> b) {
+                         return a->GetPriorityLevel() > b->GetPriorityLevel();
+                     });
+    ResetClassState();
+
+    uint32_t n = q_class.size();
+    m_levels.assign(n, 0);
+    m_levelEnd.clear();
+    m_levelTurn.clear();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (i == 0 || q_class[i]->GetPriorityLevel() != q_class[i - 1]->GetPriorityLevel())
+        {
+            m_levelTurn.push_back(i);
+            m_levelEnd.push_back(i);
+        }
+        m_levels[i] = m_levelEnd.size() - 1;
+        m_levelEnd.back() = i + 1;
+    }
+
+    m_green.Reset();
+    m_yellow.Reset();
+    m_waitQueue.Reset(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        UpdateColor(i);
+    }
+}
+
+/**
+ * @brief Schedules the next packet for transmission using HTB.
+ * @return A pointer to the packet to be dequeued, or nullptr if no class may send.
+ */
+Ptr<Packet>
+HtbQueue::Schedule()
+{
+    return ServeSelection();
+}
+
+/**
+ * @brief Green classes first, then yellow ones. The stored colors are exact until the first
+ *        entry of the wait queue is due; from then until CommitSelection recolors the due
+ *        classes, only those are recolored, on scratch copies of the bitmaps.
+ */
+int32_t
+HtbQueue::GetQueueForSchedule() const
+{
+    double now = Simulator::Now().GetNanoSeconds();
+    if (m_waitQueue.GetSize() == 0 || m_waitQueue.TopKey() > now)
+    {
+        int32_t selected = SelectFrom(m_green);
+        return selected >= 0 ? selected : SelectFrom(m_yellow);
+    }
+
+    PriorityBitmap green = m_green;
+    PriorityBitmap yellow = m_yellow;
+    m_waitQueue.CollectAtMost(now, m_due);
+    for (uint32_t index : m_due)
+    {
+        green.Clear(index);
+        yellow.Clear(index);
+        Color color = GetColor(index);
+        if (color == GREEN)
+            green.Set(index);
+        else if (color == YELLOW)
+            yellow.Set(index);
+    }
+
+    int32_t selected = SelectFrom(green);
+    return selected >= 0 ? selected : SelectFrom(yellow);
+}
+
+/**
+ * @brief The first set class gives the priority level; within the level the first set class
+ *        at or after the one whose turn it is wins, wrapping around to the first set class.
+ */
+int32_t
+HtbQueue::SelectFrom(const PriorityBitmap& ready) const
+{
+    int32_t first = ready.FindFirst();
+    if (first < 0)
+    {
+        return -1;
+    }
+
+    uint32_t level = m_levels[first];
+    uint32_t turn = m_levelTurn[level];
+    if (turn > static_cast<uint32_t>(first))
+    {
+        int32_t next = ready.FindNext(turn - 1);
+        if (next >= 0 && static_cast<uint32_t>(next) < m_levelEnd[level])
+        {
+            return next;
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief Apply the color changes that became due while the class was waiting.
+ */
+void
+HtbQueue::CommitSelection(uint32_t index)
+{
+    double now = Simulator::Now().GetNanoSeconds();
+    while (m_waitQueue.GetSize() > 0 && m_waitQueue.TopKey() <= now)
+    {
+        UpdateColor(m_waitQueue.Top());
+    }
+}
+
+/**
+ * @brief A class's color only improves as time passes, so it is refreshed whenever its head
+ *        packet changes.
+ */
+void
+HtbQueue::NotifyEnqueue(uint32_t index)
+{
+    UpdateColor(index);
+}
+
+/**
+ * @brief An empty class has no color; its turn and the rest of its quantum are kept.
+ */
+void
+HtbQueue::NotifyDrained(uint32_t index)
+{
+    UpdateColor(index);
+}
+
+/**
+ * @brief A zero deficit means the class starts a fresh turn of one quantum.
+ */
+uint32_t
+HtbQueue::GetBurstBytes(uint32_t index) const
+{
+    return m_deficits[index] > 0 ? m_deficits[index] : m_weights[index];
+}
+
+/**
+ * @brief Once its quantum is used up the class's turn ends and the next class of its priority
+ *        level goes on; the overrun of the last packet is not carried over, as weights are
+ *        expected to be at least one MTU.
+ */
+void
+HtbQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    uint32_t level = m_levels[index];
+    uint32_t left = GetBurstBytes(index);
+    if (bytes < left)
+    {
+        m_deficits[index] = left - bytes;
+        m_levelTurn[level] = index;
+    }
+    else
+    {
+        m_deficits[index] = 0;
+        uint32_t levelStart = level == 0 ? 0 : m_levelEnd[level - 1];
+        m_levelTurn[level] = index + 1 < m_levelEnd[level] ? index + 1 : levelStart;
+    }
+
+    UpdateColor(index);
+}
+
+/**
+ * @brief Red if the ceil bucket (or the child scheduler) does not allow the head packet, else
+ *        green or yellow depending on the rate bucket.
+ */
+HtbQueue::Color
+HtbQueue::GetColor(uint32_t index) const
+{
+    if (!IsEligible(index))
+    {
+        return RED;
+    }
+    return GetTrafficClasses()[index]->IsWithinRate() ? GREEN : YELLOW;
+}
+
+/**
+ * @brief Yellow and red classes are parked in the wait queue until the time their color next
+ *        improves; a yellow class with no rate at all never turns green and is not parked.
+ */
+void
+HtbQueue::UpdateColor(uint32_t index)
+{
+    m_green.Clear(index);
+    m_yellow.Clear(index);
+    if (m_waitQueue.Contains(index))
+    {
+        m_waitQueue.Remove(index);
+    }
+
+    if (m_backlogs[index] == 0)
+    {
+        return;
+    }
+
+    Ptr<TrafficClass> tc = GetTrafficClasses()[index];
+    Time recolor;
+    switch (GetColor(index))
+    {
+    case GREEN:
+        m_green.Set(index);
+        return;
+    case YELLOW:
+        m_yellow.Set(index);
+        recolor = tc->GetNextWithinRateTime();
+        break;
+    case RED:
+        recolor = tc->GetNextConformingTime();
+        break;
+    }
+
+    if (recolor != Time::Max())
+    {
+        // Never due right away, so that CommitSelection cannot keep recoloring the same class
+        recolor = std::max(recolor, Simulator::Now() + NanoSeconds(1));
+        m_waitQueue.Push(index, recolor.GetNanoSeconds());
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef HTB_QUEUE_H
+#define HTB_QUEUE_H
+
+#include "diff-serv.h"
+#include "indexed-heap.h"
+
+namespace ns3
+{
+
+/**
+ * @brief A DiffServ-based class implementing one node of a Hierarchical Token Bucket tree.
+ *
+ * Every class has an assured rate and a ceil. A class within its rate may send (green), one
+ * above its rate but within its ceil may only borrow bandwidth left over by green classes
+ * (yellow), and one above its ceil waits (red). Green classes are served before yellow ones;
+ * within a color the highest priority level wins and classes of equal priority take turns of
+ * one quantum (weight) each.
+ *
+ * A class backed by a child scheduler (TrafficClass::SetChild), typically another HtbQueue,
+ * makes up the tree: its buckets limit the whole subtree, so a child class borrows from its
+ * parent simply by being served while the parent still conforms.
+ *
+ * The colors of backlogged classes are kept in two bitmaps, and a class that will change color
+ * as its buckets refill waits in a heap keyed by that time, so that selection at each level is
+ * a pair of find-first-set operations rather than a scan of the children.
+ */
+class HtbQueue : public DiffServ
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Default constructor for HtbQueue.
+     */
+    HtbQueue();
+
+    /**
+     * @brief Schedule the next packet to dequeue using HTB.
+     *
+     * @return The next scheduled packet, or nullptr if no packets are available.
+     */
+    Ptr<Packet> Schedule() override;
+
+    /**
+     * @brief Classify a packet into one of the traffic classes.
+     *
+     * @param p The packet to classify.
+     * @return Index of the matching traffic class, or -1 if none match.
+     */
+    int32_t Classify(Ptr<Packet> p) override;
+
+    /**
+     * @brief Add a traffic class, keeping the classes sorted by descending priority.
+     *
+     * @param trafficClass Pointer to the TrafficClass to add.
+     */
+    void AddTrafficClass(Ptr<TrafficClass> trafficClass) override;
+
+  protected:
+    /**
+     * @brief Initialize the HTB queue from its JSON configuration.
+     */
+    void DoInitialize() override;
+
+    /**
+     * @brief Recolor a class whose head packet may have changed.
+     *
+     * @param index Index of the class that received a packet.
+     */
+    void NotifyEnqueue(uint32_t index) override;
+
+    /**
+     * @brief Take an emptied class out of the color bitmaps and the wait queue.
+     *
+     * @param index Index of the class that became empty.
+     */
+    void NotifyDrained(uint32_t index) override;
+
+    /**
+     * @brief Recolor the classes whose wait time has passed.
+     *
+     * @param index Index of the selected class.
+     */
+    void CommitSelection(uint32_t index) override;
+
+    /**
+     * @brief A class may send the rest of its turn.
+     *
+     * @param index Index of the selected class.
+     * @return The bytes left of the class's quantum.
+     */
+    uint32_t GetBurstBytes(uint32_t index) const override;
+
+    /**
+     * @brief Charge the bytes sent against the class's turn and recolor it.
+     *
+     * @param index Index of the class.
+     * @param bytes Bytes sent.
+     */
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    /**
+     * @brief Get the class HTB serves next.
+     *
+     * @return Index of the selected class, or -1 if every backlogged class is red.
+     */
+    int32_t GetQueueForSchedule() const override;
+
+  private:
+    /**
+     * @brief Class colors, from the best to the worst.
+     */
+    enum Color
+    {
+        GREEN,  //!< Within its rate
+        YELLOW, //!< Above its rate, within its ceil
+        RED,    //!< Above its ceil, or its child scheduler cannot send
+    };
+
+    /**
+     * @brief Compute the current color of a backlogged class from its buckets.
+     *
+     * @param index Index of the class.
+     * @return The color.
+     */
+    Color GetColor(uint32_t index) const;
+
+    /**
+     * @brief Update the bitmaps and the wait queue entry of a class to its current color.
+     *
+     * @param index Index of the class.
+     */
+    void UpdateColor(uint32_t index);
+
+    /**
+     * @brief Pick the class whose turn it is among the highest-priority classes set in a bitmap.
+     *
+     * @param ready Bitmap of the candidate classes.
+     * @return Index of the class, or -1 if the bitmap is empty.
+     */
+    int32_t SelectFrom(const PriorityBitmap& ready) const;
+
+    std::string m_configFile; // <- come from SetAttribute
+
+    PriorityBitmap m_green;              //!< Backlogged classes within their rate
+    PriorityBitmap m_yellow;             //!< Backlogged classes borrowing up to their ceil
+    IndexedHeap m_waitQueue;             //!< Yellow and red classes keyed by recolor time in ns
+    mutable std::vector<uint32_t> m_due; //!< Scratch list of the wait queue entries that are due
+    std::vector<uint32_t> m_levels;      //!< Priority level group of each class
+    std::vector<uint32_t> m_levelEnd;    //!< One past the last class of each group
+    std::vector<uint32_t> m_levelTurn;   //!< Class of each group whose turn it is
+};
+
+} // namespace ns3
+
+#endif // HTB_QUEUE_H
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "indexed-heap.h"
+
+#include <utility>
+
+namespace ns3
+{
+
+IndexedHeap::IndexedHeap()
+{
+}
+
+void
+IndexedHeap::Reset(uint32_t classes)
+{
+    m_heap.clear();
+    m_heap.reserve(classes);
+    m_keys.assign(classes, 0);
+    m_positions.assign(classes, -1);
+}
+
+void
+IndexedHeap::Push(uint32_t index, double key)
+{
+    if (m_positions[index] < 0)
+    {
+        m_positions[index] = m_heap.size();
+        m_heap.push_back(index);
+        m_keys[index] = key;
+        SiftUp(m_positions[index]);
+        return;
+    }
+
+    double old = m_keys[index];
+    m_keys[index] = key;
+    if (key < old)
+    {
+        SiftUp(m_positions[index]);
+    }
+    else
+    {
+        SiftDown(m_positions[index]);
+    }
+}
+
+/**
+ * @brief The last entry takes the place of the removed one and is sifted whichever way its
+ *        key requires.
+ */
+void
+IndexedHeap::Remove(uint32_t index)
+{
+    int32_t position = m_positions[index];
+    if (position < 0)
+    {
+        return;
+    }
+
+    uint32_t last = m_heap.size() - 1;
+    if (static_cast<uint32_t>(position) != last)
+    {
+        Swap(position, last);
+    }
+    m_heap.pop_back();
+    m_positions[index] = -1;
+
+    if (static_cast<uint32_t>(position) < m_heap.size())
+    {
+        SiftUp(position);
+        SiftDown(m_positions[m_heap[position]]);
+    }
+}
+
+bool
+IndexedHeap::Contains(uint32_t index) const
+{
+    return m_positions[index] >= 0;
+}
+
+int32_t
+IndexedHeap::Top() const
+{
+    return m_heap.empty() ? -1 : static_cast<int32_t>(m_heap[0]);
+}
+
+double
+IndexedHeap::TopKey() const
+{
+    return m_keys[m_heap[0]];
+}
+
+double
+IndexedHeap::GetKey(uint32_t index) const
+{
+    return m_keys[index];
+}
+
+uint32_t
+IndexedHeap::GetSize() const
+{
+    return m_heap.size();
+}
+
+uint32_t
+IndexedHeap::GetAt(uint32_t position) const
+{
+    return m_heap[position];
+}
+
+/**
+ * @brief Breadth-first walk from the root that stops at every entry above the bound, since its
+ *        whole subtree is above it too. The output vector doubles as the work list: it holds
+ *        heap positions until the walk ends and is then mapped to class indices.
+ */
+void
+IndexedHeap::CollectAtMost(double key, std::vector<uint32_t>& classes) const
+{
+    classes.clear();
+    if (m_heap.empty() || m_keys[m_heap[0]] > key)
+    {
+        return;
+    }
+
+    uint32_t n = m_heap.size();
+    classes.push_back(0);
+    for (uint32_t i = 0; i < classes.size(); ++i)
+    {
+        uint32_t left = 2 * classes[i] + 1;
+        for (uint32_t child = left; child <= left + 1 && child < n; ++child)
+        {
+            if (m_keys[m_heap[child]] <= key)
+            {
+                classes.push_back(child);
+            }
+        }
+    }
+
+    for (uint32_t& entry : classes)
+    {
+        entry = m_heap[entry];
+    }
+}
+
+bool
+IndexedHeap::Less(uint32_t a, uint32_t b) const
+{
+    double keyA = m_keys[m_heap[a]];
+    double keyB = m_keys[m_heap[b]];
+    return keyA < keyB || (keyA == keyB && m_heap[a] < m_heap[b]);
+}
+
+void
+IndexedHeap::Swap(uint32_t a, uint32_t b)
+{
+    std::swap(m_heap[a], m_heap[b]);
+    m_positions[m_heap[a]] = a;
+    m_positions[m_heap[b]] = b;
+}
+
+void
+IndexedHeap::SiftUp(uint32_t position)
+{
+    while (position > 0)
+    {
+        uint32_t parent = (position - 1) / 2;
+        if (!Less(position, parent))
+        {
+            break;
+        }
+        Swap(position, parent);
+        position = parent;
+    }
+}
+
+void
+IndexedHeap::SiftDown(uint32_t position)
+{
+    uint32_t n = m_heap.size();
+    while (true)
+    {
+        uint32_t smallest = position;
+        uint32_t left = 2 * position + 1;
+        uint32_t right = left + 1;
+        if (left < n && Less(left, smallest))
+        {
+            smallest = left;
+        }
+        if (right < n && Less(right, smallest))
+        {
+            smallest = right;
+        }
+        if (smallest == position)
+        {
+            break;
+        }
+        Swap(position, smallest);
+        position = smallest;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Binary min-heap of traffic class indices keyed by a virtual time.
+ *
+ * Each class is in the heap at most once, and its position is tracked so that it can be
+ * removed or re-keyed in O(log n). Equal keys are ordered by class index, so schedulers built
+ * on it stay deterministic.
+ */
+class IndexedHeap
+{
+  public:
+    IndexedHeap();
+
+    /**
+     * @brief Empty the heap and size it for a number of classes.
+     *
+     * @param classes Number of class indices the heap may hold.
+     */
+    void Reset(uint32_t classes);
+
+    /**
+     * @brief Insert a class, or change its key if it is already in the heap.
+     *
+     * @param index The class index.
+     * @param key The key to order it by.
+     */
+    void Push(uint32_t index, double key);
+
+    /**
+     * @brief Remove a class if it is in the heap.
+     *
+     * @param index The class index.
+     */
+    void Remove(uint32_t index);
+
+    /**
+     * @brief Check whether a class is in the heap.
+     *
+     * @param index The class index.
+     * @return true if the class is in the heap.
+     */
+    bool Contains(uint32_t index) const;
+
+    /**
+     * @brief Get the class with the smallest key.
+     *
+     * @return The class index, or -1 if the heap is empty.
+     */
+    int32_t Top() const;
+
+    /**
+     * @brief Get the smallest key.
+     *
+     * @return The key of Top(); only meaningful if the heap is not empty.
+     */
+    double TopKey() const;
+
+    /**
+     * @brief Get the key of a class in the heap.
+     *
+     * @param index The class index, which must be in the heap.
+     * @return Its key.
+     */
+    double GetKey(uint32_t index) const;
+
+    /**
+     * @brief Get the number of classes in the heap.
+     *
+     * @return The size.
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * @brief Get the class at a heap position, for scans that do not care about order.
+     *
+     * @param position Position below GetSize().
+     * @return The class index.
+     */
+    uint32_t GetAt(uint32_t position) const;
+
+    /**
+     * @brief Collect the classes whose key is at most a bound, in no particular order.
+     *
+     * Only subtrees whose root is within the bound are visited, so the cost is proportional to
+     * the number of classes collected.
+     *
+     * @param key The bound.
+     * @param classes Cleared, then receives the class indices.
+     */
+    void CollectAtMost(double key, std::vector<uint32_t>& classes) const;
+
+  private:
+    /**
+     * @brief Check whether the entry at position a sorts before the one at position b.
+     */
+    bool Less(uint32_t a, uint32_t b) const;
+
+    /**
+     * @brief Swap two heap positions and update the position table.
+     */
+    void Swap(uint32_t a, uint32_t b);
+
+    /**
+     * @brief Move an entry towards the root until the heap property holds.
+     */
+    void SiftUp(uint32_t position);
+
+    /**
+     * @brief Move an entry towards the leaves until the heap property holds.
+     */
+    void SiftDown(uint32_t position);
+
+    std::vector<uint32_t> m_heap;     //!< Class indices in heap order
+    std::vector<double> m_keys;       //!< Key of each class, indexed by class
+    std::vector<int32_t> m_positions; //!< Heap position of each class, -1 if absent
+};
+
+} // namespace ns3
+
+#endif // INDEXED_HEAP_H
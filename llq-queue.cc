@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "llq-queue.h"
+
+#include "qos-initializer.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("LlqQueue");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(LlqQueue);
+
+// TypeId registration with ns-3, the Config attribute is inherited from DrrQueue
+TypeId
+LlqQueue::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LlqQueue<Packet>")
+                            .SetParent<DrrQueue>()
+                            .SetGroupName("Network")
+                            .AddConstructor<LlqQueue>();
+    return tid;
+}
+
+LlqQueue::LlqQueue()
+{
+}
+
+/**
+ * @brief Initializes the LLQ queue using a JSON config file, bypassing the DRR initializer.
+ */
+void
+LlqQueue::DoInitialize()
+{
+    DiffServ::DoInitialize();
+    QosInitializer::InitializeLlqFromJson(this, m_configFile);
+}
+
+/**
+ * @brief Add a traffic class. Classes keep their configured order for the DRR round, while the
+ *        low-latency ones are additionally ranked by priority level.
+ */
+void
+LlqQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
+{
+    DrrQueue::AddTrafficClass(trafficClass);
+
+    const std::vector<Ptr<TrafficClass>>& classes = GetTrafficClasses();
+    m_lowLatencyOrder.clear();
+    for (uint32_t i = 0; i < classes.size(); ++i)
+    {
+        if (classes[i]->IsLowLatency())
+            m_lowLatencyOrder.push_back(i);
+    }
+
+    std::stable_sort(m_lowLatencyOrder.begin(),
+                     m_lowLatencyOrder.end(),
+                     [&classes](uint32_t a, uint32_t b) {
+                         return classes[a]->GetPriorityLevel() > classes[b]->GetPriorityLevel();
+                     });
+}
+
+/**
+ * @brief Serve the low-latency classes in strict priority, then fall back to the DRR active
+ *        list, which only ever holds the weighted classes.
+ */
+int32_t
+LlqQueue::GetQueueForSchedule() const
+{
+    for (uint32_t index : m_lowLatencyOrder)
+    {
+        if (IsEligible(index))
+            return index;
+    }
+
+    return DrrQueue::GetQueueForSchedule();
+}
+
+/**
+ * @brief Low-latency classes are limited by their policer rather than a deficit.
+ */
+uint32_t
+LlqQueue::GetBurstBytes(uint32_t index) const
+{
+    if (GetTrafficClasses()[index]->IsLowLatency())
+        return DiffServ::GetBurstBytes(index);
+
+    return DrrQueue::GetBurstBytes(index);
+}
+
+/**
+ * @brief Low-latency classes never join the DRR active list.
+ */
+void
+LlqQueue::NotifyEnqueue(uint32_t index)
+{
+    if (GetTrafficClasses()[index]->IsLowLatency())
+        return;
+
+    DrrQueue::NotifyEnqueue(index);
+}
+
+/**
+ * @brief Only a decision made by the DRR round has quantum credits to apply.
+ */
+void
+LlqQueue::CommitSelection(uint32_t index)
+{
+    if (GetTrafficClasses()[index]->IsLowLatency())
+        return;
+
+    DrrQueue::CommitSelection(index);
+}
+
+/**
+ * @brief Keeps the low-latency classes, whose weight is never configured, out of the weighted
+ *        round robin sequence.
+ */
+bool
+LlqQueue::IsInRound(uint32_t index) const
+{
+    return !GetTrafficClasses()[index]->IsLowLatency();
+}
+
+/**
+ * @brief Only DRR classes carry a deficit to charge.
+ */
+void
+LlqQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    if (GetTrafficClasses()[index]->IsLowLatency())
+        return;
+
+    DrrQueue::ChargeClass(index, bytes);
+}
+
+} // namespace ns3
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef LLQ_QUEUE_H
+#define LLQ_QUEUE_H
+
+#include "drr-queue.h"
+
+namespace ns3
+{
+
+/**
+ * @brief Low Latency Queueing: strict priority classes on top of Deficit Round Robin.
+ *
+ * Classes configured with lowLatency are served first, highest priorityLevel first, and are
+ * expected to carry a policer (policeRate/policeBurst) so they cannot starve the rest. All
+ * other classes share the remaining capacity with the DRR logic inherited from DrrQueue.
+ */
+class LlqQueue : public DrrQueue
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Default constructor for LlqQueue.
+     */
+    LlqQueue();
+
+    /**
+     * @brief Add a traffic class and rebuild the low-latency service order.
+     *
+     * @param trafficClass Pointer to the TrafficClass to add.
+     */
+    void AddTrafficClass(Ptr<TrafficClass> trafficClass) override;
+
+  protected:
+    /**
+     * @brief Initialize the LLQ queue from its JSON configuration.
+     */
+    void DoInitialize() override;
+
+    /**
+     * @brief A low-latency class may drain while it stays eligible, other classes are bound
+     *        by their deficit.
+     *
+     * @param index Index of the selected class.
+     * @return The byte allowance of the class.
+     */
+    uint32_t GetBurstBytes(uint32_t index) const override;
+
+    /**
+     * @brief Charge the deficit of a DRR class; low-latency classes have none.
+     *
+     * @param index Index of the class.
+     * @param bytes Bytes sent.
+     */
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    /**
+     * @brief Keep low-latency classes off the DRR active list.
+     *
+     * @param index Index of the class that received a packet.
+     */
+    void NotifyEnqueue(uint32_t index) override;
+
+    /**
+     * @brief Serving a low-latency class leaves the DRR round untouched.
+     *
+     * @param index Index of the selected class.
+     */
+    void CommitSelection(uint32_t index) override;
+
+    /**
+     * @brief Pick the first eligible low-latency class, or fall back to DRR.
+     *
+     * @return Index of the selected class, or -1 if nothing can be sent.
+     */
+    int32_t GetQueueForSchedule() const override;
+
+    /**
+     * @brief Low-latency classes are served ahead of the round and take no part in it.
+     *
+     * @param index Index of the class.
+     * @return true if the class is not a low-latency class.
+     */
+    bool IsInRound(uint32_t index) const override;
+
+  private:
+    std::vector<uint32_t> m_lowLatencyOrder; //!< Low-latency classes by descending priority
+};
+
+} // namespace ns3
+
+#endif // LLQ_QUEUE_H
@@ -45,8 +45,10 @@ SetupSpqTopology(std::string configFile)
     p2p12.SetDeviceAttribute("DataRate", StringValue("1Mbps"));
     p2p12.SetChannelAttribute("Delay", StringValue("2ms"));
 
-    //  New: Set router's outgoing NetDevice to use SPQ
-    p2p12.SetQueue("ns3::StrictPriorityQueue<Packet>", "Config", StringValue(configFile));
+    //  New: Set router's outgoing NetDevice to the scheduler named by "type" in the config
+    p2p12.SetQueue(QosInitializer::GetQueueTypeFromJson(configFile),
+                   "Config",
+                   StringValue(configFile));
 
     dev01 = p2p01.Install(nodes.Get(0), nodes.Get(1));
     dev12 = p2p12.Install(nodes.Get(1), nodes.Get(2));
@@ -54,8 +56,13 @@ SetupSpqTopology(std::string configFile)
     Ptr<PointToPointNetDevice> routerDev = dev12.Get(0)->GetObject<PointToPointNetDevice>();
 
     Ptr<Queue<Packet>> queue = routerDev->GetQueue();
-    Ptr<StrictPriorityQueue> spq = DynamicCast<StrictPriorityQueue>(queue);
-    spq->Initialize();
+    Ptr<DiffServ> diffServ = DynamicCast<DiffServ>(queue);
+    diffServ->Initialize();
+    // The device would be handed a null packet once every backlogged class is out of tokens
+    NS_ABORT_MSG_IF(!diffServ->IsWorkConserving(),
+                    "Shaped classes need the scheduler installed as ns3::DiffServQueueDisc, "
+                    "not as the device queue: "
+                        << configFile);
 
     InternetStackHelper stack;
     stack.InstallAll();
@@ -125,6 +132,12 @@ main(int argc, char* argv[])
     Ipv4GlobalRoutingHelper::PopulateRoutingTables();
     Simulator::Stop(Seconds(simDuration));
     Simulator::Run();
+
+    // Report per-class queueing delay at the router
+    Ptr<PointToPointNetDevice> routerDev = dev12.Get(0)->GetObject<PointToPointNetDevice>();
+    Ptr<DiffServ> router = DynamicCast<DiffServ>(routerDev->GetQueue());
+    router->ReportSojournTimes(std::cout);
+
     Simulator::Destroy();
 
     return 0;
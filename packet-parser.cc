@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "packet-parser.h"
+
+namespace ns3
+{
+
+/** PPP protocol number of IPv4 */
+static const uint16_t PPP_IPV4 = 0x0021;
+
+/**
+ * @brief Peek first, so that a packet without PPP framing is left untouched.
+ */
+bool
+PacketParser::RemovePppHeader(Ptr<Packet> p, PppHeader& pppHeader)
+{
+    if (p->PeekHeader(pppHeader) == 0 || pppHeader.GetProtocol() != PPP_IPV4)
+    {
+        return false;
+    }
+    p->RemoveHeader(pppHeader);
+    return true;
+}
+
+/**
+ * @brief The packet is copied once, whatever the number of fields the caller then matches.
+ */
+bool
+PacketParser::ParseIpv4(Ptr<const Packet> p, Ipv4Header& header, Ptr<Packet>& payload)
+{
+    payload = p->Copy();
+    PppHeader pppHeader;
+    RemovePppHeader(payload, pppHeader);
+    return payload->RemoveHeader(header) != 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef PACKET_PARSER_H
+#define PACKET_PARSER_H
+
+#include "ns3/ipv4-header.h"
+#include "ns3/packet.h"
+#include "ns3/ppp-header.h"
+
+namespace ns3
+{
+
+/**
+ * @brief Utility class to find the IPv4 header of a queued packet.
+ *
+ * A scheduler used as the queue of a point-to-point device sees PPP-framed packets, while one
+ * fed by DiffServQueueDisc sees packets starting with their IPv4 header. The PPP protocol
+ * number of IPv4 is 0x0021, and no IPv4 header starts with a zero byte, so peeking at the
+ * first two bytes tells the two apart.
+ */
+class PacketParser
+{
+  public:
+    /**
+     * @brief Remove the PPP header from the front of a packet if it carries IPv4.
+     *
+     * @param p The packet, modified in place.
+     * @param pppHeader Receives the removed header.
+     * @return true if a PPP header was removed, false if the packet starts with anything else.
+     */
+    static bool RemovePppHeader(Ptr<Packet> p, PppHeader& pppHeader);
+
+    /**
+     * @brief Parse the IPv4 header of a packet, with or without PPP framing.
+     *
+     * @param p The packet, left unchanged.
+     * @param header Receives the IPv4 header.
+     * @param payload Receives a copy of the packet behind the IPv4 header.
+     * @return false if the packet does not carry an IPv4 header.
+     */
+    static bool ParseIpv4(Ptr<const Packet> p, Ipv4Header& header, Ptr<Packet>& payload);
+};
+
+} // namespace ns3
+
+#endif // PACKET_PARSER_H
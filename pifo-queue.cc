@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "pifo-queue.h"
+
+#include "qos-initializer.h"
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+NS_LOG_COMPONENT_DEFINE("PifoQueue");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(PifoQueue);
+
+// TypeId registration with ns-3
+TypeId
+PifoQueue::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::PifoQueue<Packet>")
+                            .SetParent<DiffServ>()
+                            .SetGroupName("Network")
+                            .AddConstructor<PifoQueue>()
+                            .AddAttribute("Config",
+                                          "Path to PIFO configuration file",
+                                          StringValue(""),
+                                          MakeStringAccessor(&PifoQueue::m_configFile),
+                                          MakeStringChecker());
+    return tid;
+}
+
+PifoQueue::PifoQueue()
+    : m_rankFunction(CreateObject<StrictPriorityRank>()),
+      m_bucketed(true)
+{
+}
+
+/**
+ * @brief Initializes the PIFO queue and its rank function using a JSON config file.
+ */
+void
+PifoQueue::DoInitialize()
+{
+    DiffServ::DoInitialize();
+    QosInitializer::InitializePifoFromJson(this, m_configFile);
+}
+
+/**
+ * @brief Drop the reference to the rank function.
+ */
+void
+PifoQueue::DoDispose()
+{
+    m_rankFunction = nullptr;
+    DiffServ::DoDispose();
+}
+
+/**
+ * @brief Classify incoming packets based on filters in TrafficClass.
+ */
+int32_t
+PifoQueue::Classify(Ptr<Packet> p)
+{
+    return ClassifyByFilters(p);
+}
+
+/**
+ * @brief Add a traffic class; the rank function state is sized for the new set of classes.
+ */
+void
+PifoQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
+{
+    DiffServ::AddTrafficClass(trafficClass);
+    Rebuild();
+}
+
+/**
+ * @brief Install a rank function, choosing buckets or the heap from its rank bound.
+ */
+void
+PifoQueue::SetRankFunction(Ptr<PifoRank> rank)
+{
+    m_rankFunction = rank;
+    Rebuild();
+}
+
+/**
+ * @brief Schedules the packet with the lowest rank.
+ * @return A pointer to the packet to be dequeued, or nullptr if all queues are empty.
+ */
+Ptr<Packet>
+PifoQueue::Schedule()
+{
+    return ServeSelection();
+}
+
+/**
+ * @brief The head of the PIFO, unless its class is out of tokens; then the backlogged classes
+ *        are scanned for the lowest rank among those that may send.
+ */
+int32_t
+PifoQueue::GetQueueForSchedule() const
+{
+    int32_t top = m_bucketed ? m_buckets.Top() : m_heap.Top();
+    if (top < 0 || IsEligible(top))
+    {
+        return top;
+    }
+
+    int32_t selected = -1;
+    for (int32_t i = m_activeClasses.FindFirst(); i >= 0; i = m_activeClasses.FindNext(i))
+    {
+        if (IsEligible(i) && (selected < 0 || m_ranks[i] < m_ranks[selected]))
+            selected = i;
+    }
+    return selected;
+}
+
+/**
+ * @brief Only a class that was empty needs ranking; otherwise its head did not change.
+ */
+void
+PifoQueue::NotifyEnqueue(uint32_t index)
+{
+    if (!m_buckets.Contains(index) && !m_heap.Contains(index))
+    {
+        PushClass(index);
+    }
+}
+
+/**
+ * @brief Remove an emptied class from the PIFO.
+ */
+void
+PifoQueue::NotifyDrained(uint32_t index)
+{
+    m_buckets.Remove(index);
+    m_heap.Remove(index);
+}
+
+/**
+ * @brief Only the head packet carries the current rank.
+ */
+uint32_t
+PifoQueue::GetBurstBytes(uint32_t index) const
+{
+    return m_headSizes[index];
+}
+
+/**
+ * @brief A still backlogged class is pushed again with the rank of its new head packet.
+ */
+void
+PifoQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    m_rankFunction->NotifyDequeue(index, m_ranks[index], bytes);
+    if (m_backlogs[index] > 0)
+    {
+        PushClass(index);
+    }
+}
+
+/**
+ * @brief Rank the head packet and push the class behind any class with the same rank.
+ */
+void
+PifoQueue::PushClass(uint32_t index)
+{
+    Ptr<TrafficClass> tc = GetTrafficClasses()[index];
+    m_ranks[index] = m_rankFunction->Rank(index, tc, m_headSizes[index], tc->GetHeadEnqueueTime());
+
+    if (m_bucketed)
+    {
+        m_buckets.Push(index, m_ranks[index]);
+    }
+    else
+    {
+        m_heap.Push(index, m_ranks[index]);
+    }
+}
+
+/**
+ * @brief Reset the rank function and both PIFO structures, then rank every backlogged class.
+ */
+void
+PifoQueue::Rebuild()
+{
+    uint32_t n = m_backlogs.size();
+    m_bucketed = m_rankFunction->GetMaxRank() <= BucketQueue::MAX_RANK;
+    m_rankFunction->Reset(n);
+    m_ranks.assign(n, 0);
+    m_buckets.Reset(n);
+    m_heap.Reset(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (m_backlogs[i] > 0)
+            PushClass(i);
+    }
+}
+
+} // namespace ns3
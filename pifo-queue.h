@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef PIFO_QUEUE_H
+#define PIFO_QUEUE_H
+
+#include "bucket-queue.h"
+#include "diff-serv.h"
+#include "indexed-heap.h"
+#include "pifo-rank.h"
+
+namespace ns3
+{
+
+/**
+ * @brief A programmable DiffServ scheduler: a push-in first-out queue ordered by a pluggable
+ *        rank function.
+ *
+ * Each packet is ranked when it reaches the head of its traffic class, and the class whose head
+ * has the lowest rank is served. Rank functions bounded by BucketQueue::MAX_RANK (e.g. strict
+ * priority) use constant-time buckets, where equal ranks leave in the order they were pushed;
+ * the others (STFQ, EDF, LSTF) use an O(log n) heap, where equal ranks leave by class index.
+ */
+class PifoQueue : public DiffServ
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Default constructor for PifoQueue, ranking by strict priority.
+     */
+    PifoQueue();
+
+    /**
+     * @brief Schedule the packet with the lowest rank.
+     *
+     * @return The next scheduled packet, or nullptr if no packets are available.
+     */
+    Ptr<Packet> Schedule() override;
+
+    /**
+     * @brief Classify a packet into one of the traffic classes.
+     *
+     * @param p The packet to classify.
+     * @return Index of the matching traffic class, or -1 if none match.
+     */
+    int32_t Classify(Ptr<Packet> p) override;
+
+    /**
+     * @brief Add a traffic class and re-rank the backlogged classes.
+     *
+     * @param trafficClass Pointer to the TrafficClass to add.
+     */
+    void AddTrafficClass(Ptr<TrafficClass> trafficClass) override;
+
+    /**
+     * @brief Replace the rank function and re-rank the backlogged classes.
+     *
+     * @param rank The rank function.
+     */
+    void SetRankFunction(Ptr<PifoRank> rank);
+
+  protected:
+    /**
+     * @brief Initialize the PIFO queue from its JSON configuration.
+     */
+    void DoInitialize() override;
+
+    /**
+     * @brief Release the rank function.
+     */
+    void DoDispose() override;
+
+    /**
+     * @brief Rank the head packet of a class that just became backlogged.
+     *
+     * @param index Index of the class that received a packet.
+     */
+    void NotifyEnqueue(uint32_t index) override;
+
+    /**
+     * @brief Take an emptied class out of the PIFO.
+     *
+     * @param index Index of the class that became empty.
+     */
+    void NotifyDrained(uint32_t index) override;
+
+    /**
+     * @brief Every packet is ranked on its own, so a decision covers a single packet.
+     *
+     * @param index Index of the selected class.
+     * @return The head packet size of the class.
+     */
+    uint32_t GetBurstBytes(uint32_t index) const override;
+
+    /**
+     * @brief Report the dequeue to the rank function and rank the next head packet.
+     *
+     * @param index Index of the class that was served.
+     * @param bytes Bytes sent.
+     */
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    /**
+     * @brief Get the class whose head packet has the lowest rank.
+     *
+     * @return Index of the selected class, or -1 if all queues are empty or shaped.
+     */
+    int32_t GetQueueForSchedule() const override;
+
+  private:
+    /**
+     * @brief Rank the head packet of a backlogged class and push the class into the PIFO.
+     *
+     * @param index Index of the class.
+     */
+    void PushClass(uint32_t index);
+
+    /**
+     * @brief Empty the PIFO and push every backlogged class again.
+     */
+    void Rebuild();
+
+    std::string m_configFile; // <- come from SetAttribute
+
+    Ptr<PifoRank> m_rankFunction;  //!< Ranks the head packet of each class
+    bool m_bucketed;               //!< Whether ranks fit the buckets rather than the heap
+    std::vector<uint64_t> m_ranks; //!< Rank of the head packet of each backlogged class
+    BucketQueue m_buckets;         //!< PIFO for bounded ranks
+    IndexedHeap m_heap;            //!< PIFO for unbounded ranks
+};
+
+} // namespace ns3
+
+#endif // PIFO_QUEUE_H
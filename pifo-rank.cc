@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "pifo-rank.h"
+
+#include "bucket-queue.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(PifoRank);
+NS_OBJECT_ENSURE_REGISTERED(StrictPriorityRank);
+NS_OBJECT_ENSURE_REGISTERED(StfqRank);
+NS_OBJECT_ENSURE_REGISTERED(EdfRank);
+NS_OBJECT_ENSURE_REGISTERED(LstfRank);
+
+TypeId
+PifoRank::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::PifoRank").SetParent<Object>().SetGroupName("Network");
+    return tid;
+}
+
+void
+PifoRank::Reset(uint32_t classes)
+{
+}
+
+void
+PifoRank::NotifyDequeue(uint32_t index, uint64_t rank, uint32_t bytes)
+{
+}
+
+uint64_t
+PifoRank::GetMaxRank() const
+{
+    return std::numeric_limits<uint64_t>::max();
+}
+
+TypeId
+StrictPriorityRank::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::StrictPriorityRank")
+                            .SetParent<PifoRank>()
+                            .SetGroupName("Network")
+                            .AddConstructor<StrictPriorityRank>();
+    return tid;
+}
+
+/**
+ * @brief Priority levels above MAX_RANK share the lowest rank.
+ */
+uint64_t
+StrictPriorityRank::Rank(uint32_t index, Ptr<TrafficClass> tc, uint32_t bytes, Time arrival)
+{
+    return BucketQueue::MAX_RANK - std::min(tc->GetPriorityLevel(), BucketQueue::MAX_RANK);
+}
+
+uint64_t
+StrictPriorityRank::GetMaxRank() const
+{
+    return BucketQueue::MAX_RANK;
+}
+
+TypeId
+StfqRank::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::StfqRank")
+                            .SetParent<PifoRank>()
+                            .SetGroupName("Network")
+                            .AddConstructor<StfqRank>();
+    return tid;
+}
+
+StfqRank::StfqRank()
+    : m_virtualTime(0)
+{
+}
+
+void
+StfqRank::Reset(uint32_t classes)
+{
+    m_virtualTime = 0;
+    m_finish.assign(classes, 0);
+}
+
+/**
+ * @brief The packet starts at the later of the virtual time and the finish of the previous
+ *        packet of its class, and finishes bytes / weight later.
+ */
+uint64_t
+StfqRank::Rank(uint32_t index, Ptr<TrafficClass> tc, uint32_t bytes, Time arrival)
+{
+    uint64_t start = std::max(m_virtualTime, m_finish[index]);
+    m_finish[index] = start + (uint64_t(bytes) << 16) / tc->GetWeight();
+    return start;
+}
+
+/**
+ * @brief Self-clocked virtual time: the start tag of the packet in service.
+ */
+void
+StfqRank::NotifyDequeue(uint32_t index, uint64_t rank, uint32_t bytes)
+{
+    m_virtualTime = rank;
+}
+
+TypeId
+EdfRank::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::EdfRank")
+                            .SetParent<PifoRank>()
+                            .SetGroupName("Network")
+                            .AddConstructor<EdfRank>();
+    return tid;
+}
+
+uint64_t
+EdfRank::Rank(uint32_t index, Ptr<TrafficClass> tc, uint32_t bytes, Time arrival)
+{
+    return (arrival + tc->GetDelayBudget()).GetNanoSeconds();
+}
+
+TypeId
+LstfRank::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LstfRank")
+                            .SetParent<PifoRank>()
+                            .SetGroupName("Network")
+                            .AddConstructor<LstfRank>()
+                            .AddAttribute("LinkRate",
+                                          "Rate of the link the queue feeds",
+                                          DataRateValue(DataRate("1Mbps")),
+                                          MakeDataRateAccessor(&LstfRank::m_linkRate),
+                                          MakeDataRateChecker());
+    return tid;
+}
+
+/**
+ * @brief Slack is the same for every packet at a given time up to this constant, so ordering
+ *        by deadline minus transmission time is ordering by slack.
+ */
+uint64_t
+LstfRank::Rank(uint32_t index, Ptr<TrafficClass> tc, uint32_t bytes, Time arrival)
+{
+    Time deadline = arrival + tc->GetDelayBudget();
+    Time transmission = m_linkRate.CalculateBytesTxTime(bytes);
+    return std::max<int64_t>(0, (deadline - transmission).GetNanoSeconds());
+}
+
+} // namespace ns3
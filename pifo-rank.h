@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef PIFO_RANK_H
+#define PIFO_RANK_H
+
+#include "traffic-class.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/object.h"
+
+#include <limits>
+
+namespace ns3
+{
+
+/**
+ * @brief Base class of the rank functions a PifoQueue orders packets by.
+ *
+ * A rank function assigns a rank to each packet when it reaches the head of its traffic class;
+ * lower ranks leave first. Rank functions are ns-3 objects, so a new one is registered simply
+ * by giving it a TypeId, and the configuration file selects it by name.
+ */
+class PifoRank : public Object
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Forget all per-class state.
+     *
+     * @param classes Number of traffic classes.
+     */
+    virtual void Reset(uint32_t classes);
+
+    /**
+     * @brief Compute the rank of a packet that has just become the head of its class.
+     *
+     * @param index Index of the class.
+     * @param tc The class.
+     * @param bytes Size of the packet.
+     * @param arrival Time the packet was enqueued.
+     * @return The rank.
+     */
+    virtual uint64_t Rank(uint32_t index, Ptr<TrafficClass> tc, uint32_t bytes, Time arrival) = 0;
+
+    /**
+     * @brief Called when a ranked packet leaves the queue, e.g. to advance a virtual clock.
+     *
+     * @param index Index of the class.
+     * @param rank Rank the packet was given.
+     * @param bytes Bytes sent.
+     */
+    virtual void NotifyDequeue(uint32_t index, uint64_t rank, uint32_t bytes);
+
+    /**
+     * @brief Get the largest rank this function returns.
+     *
+     * Ranks up to BucketQueue::MAX_RANK let the PIFO use constant-time buckets; larger ranges
+     * fall back to a heap.
+     *
+     * @return The bound; unbounded by default.
+     */
+    virtual uint64_t GetMaxRank() const;
+};
+
+/**
+ * @brief Strict priority: a higher priorityLevel gives a lower rank.
+ */
+class StrictPriorityRank : public PifoRank
+{
+  public:
+    static TypeId GetTypeId();
+
+    uint64_t Rank(uint32_t index, Ptr<TrafficClass> tc, uint32_t bytes, Time arrival) override;
+
+    uint64_t GetMaxRank() const override;
+};
+
+/**
+ * @brief Start-time fair queueing: the rank is the virtual start time of the packet.
+ *
+ * Virtual times are kept in fixed point, 1/65536 byte per unit of weight.
+ */
+class StfqRank : public PifoRank
+{
+  public:
+    static TypeId GetTypeId();
+
+    StfqRank();
+
+    void Reset(uint32_t classes) override;
+
+    uint64_t Rank(uint32_t index, Ptr<TrafficClass> tc, uint32_t bytes, Time arrival) override;
+
+    void NotifyDequeue(uint32_t index, uint64_t rank, uint32_t bytes) override;
+
+  private:
+    uint64_t m_virtualTime;         //!< Start tag of the packet last sent
+    std::vector<uint64_t> m_finish; //!< Finish tag of the last packet ranked in each class
+};
+
+/**
+ * @brief Earliest deadline first: the rank is arrival time plus the class delayBudget, in ns.
+ */
+class EdfRank : public PifoRank
+{
+  public:
+    static TypeId GetTypeId();
+
+    uint64_t Rank(uint32_t index, Ptr<TrafficClass> tc, uint32_t bytes, Time arrival) override;
+};
+
+/**
+ * @brief Least slack time first: the deadline minus the time still needed to transmit the
+ *        packet at LinkRate, in ns.
+ */
+class LstfRank : public PifoRank
+{
+  public:
+    static TypeId GetTypeId();
+
+    uint64_t Rank(uint32_t index, Ptr<TrafficClass> tc, uint32_t bytes, Time arrival) override;
+
+  private:
+    DataRate m_linkRate; //!< Rate of the link the queue feeds
+};
+
+} // namespace ns3
+
+#endif // PIFO_RANK_H
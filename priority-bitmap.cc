@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "priority-bitmap.h"
+
+namespace ns3
+{
+
+/** Bit of a 64-bit word holding position i, most significant bit first */
+static inline uint64_t
+MsbFirst(uint32_t i)
+{
+    return uint64_t(1) << (63 - i);
+}
+
+PriorityBitmap::PriorityBitmap()
+{
+    Reset();
+}
+
+void
+PriorityBitmap::Reset()
+{
+    m_summary = 0;
+    m_words.fill(0);
+}
+
+void
+PriorityBitmap::Set(uint32_t index)
+{
+    m_words[index >> 6] |= MsbFirst(index & 63);
+    m_summary |= MsbFirst(index >> 6);
+}
+
+void
+PriorityBitmap::Clear(uint32_t index)
+{
+    uint64_t& word = m_words[index >> 6];
+    word &= ~MsbFirst(index & 63);
+    if (word == 0)
+    {
+        m_summary &= ~MsbFirst(index >> 6);
+    }
+}
+
+bool
+PriorityBitmap::Test(uint32_t index) const
+{
+    return m_words[index >> 6] & MsbFirst(index & 63);
+}
+
+/**
+ * @brief The leading set bit of the summary picks the word, the leading set bit of that word
+ *        picks the slot.
+ */
+int32_t
+PriorityBitmap::FindFirst() const
+{
+    if (m_summary == 0)
+    {
+        return -1;
+    }
+
+    uint32_t w = __builtin_clzll(m_summary);
+    return (w << 6) + __builtin_clzll(m_words[w]);
+}
+
+/**
+ * @brief Look in the rest of the current word first, then in the next non-zero word.
+ */
+int32_t
+PriorityBitmap::FindNext(uint32_t index) const
+{
+    uint32_t next = index + 1;
+    if (next >= MAX_SLOTS)
+    {
+        return -1;
+    }
+
+    uint32_t w = next >> 6;
+    uint64_t rest = m_words[w] & (~uint64_t(0) >> (next & 63));
+    if (rest != 0)
+    {
+        return (w << 6) + __builtin_clzll(rest);
+    }
+
+    uint64_t laterWords = (w == 63) ? 0 : (m_summary & (~uint64_t(0) >> (w + 1)));
+    if (laterWords == 0)
+    {
+        return -1;
+    }
+
+    w = __builtin_clzll(laterWords);
+    return (w << 6) + __builtin_clzll(m_words[w]);
+}
+
+} // namespace ns3
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef PRIORITY_BITMAP_H
+#define PRIORITY_BITMAP_H
+
+#include <array>
+#include <cstdint>
+
+namespace ns3
+{
+
+/**
+ * @brief Two-level bitmap of up to 4096 slots with constant-time lowest-index lookup.
+ *
+ * Slot i is stored in word i / 64, most significant bit first, and a summary word records which
+ * words are non-zero. Finding the first set slot therefore takes two count-leading-zeros
+ * instructions, independent of the number of slots.
+ */
+class PriorityBitmap
+{
+  public:
+    static constexpr uint32_t MAX_SLOTS = 64 * 64; //!< Largest supported number of slots
+
+    PriorityBitmap();
+
+    /**
+     * @brief Clear every slot.
+     */
+    void Reset();
+
+    /**
+     * @brief Mark a slot as set.
+     *
+     * @param index The slot, below MAX_SLOTS.
+     */
+    void Set(uint32_t index);
+
+    /**
+     * @brief Mark a slot as clear.
+     *
+     * @param index The slot, below MAX_SLOTS.
+     */
+    void Clear(uint32_t index);
+
+    /**
+     * @brief Check whether a slot is set.
+     *
+     * @param index The slot, below MAX_SLOTS.
+     * @return true if the slot is set.
+     */
+    bool Test(uint32_t index) const;
+
+    /**
+     * @brief Find the lowest set slot.
+     *
+     * @return The slot, or -1 if no slot is set.
+     */
+    int32_t FindFirst() const;
+
+    /**
+     * @brief Find the lowest set slot above a given one.
+     *
+     * @param index The slot to start after.
+     * @return The slot, or -1 if no higher slot is set.
+     */
+    int32_t FindNext(uint32_t index) const;
+
+  private:
+    uint64_t m_summary;               //!< Bit 63 - w is set when m_words[w] is non-zero
+    std::array<uint64_t, 64> m_words; //!< Bit 63 - (i % 64) of word i / 64 holds slot i
+};
+
+} // namespace ns3
+
+#endif // PRIORITY_BITMAP_H
@@ -11,10 +11,13 @@
 #include "./spq.h"
 #include "json.hpp"
 
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/string.h"
 
 #include <fstream>
+#include <map>
 
 // Use nlohmann JSON library
 using json = nlohmann::json;
@@ -26,6 +29,21 @@ static nlohmann::json LoadJson(const std::string& filepath);
 static Ptr<Filter> CreateFilter(const json& filterConf);
 static Ptr<FilterElement> CreateFilterElement(const json& filterElementConf);
 static Ipv4Mask MakeIpv4MaskFromPrefixLength(uint8_t prefixLength);
+static void SetOptionalClassAttributes(ObjectFactory& tcFactory, const json& queueConf);
+static void SetOptionalQueueAttributes(Ptr<DiffServ> diffServ, const json& config);
+static uint32_t GetWeight(const json& queueConf);
+static void AddWeightedClasses(Ptr<DiffServ> diffServ, const json& config);
+static void AddClasses(Ptr<DiffServ> diffServ, const json& config);
+static void SetServiceCurve(ObjectFactory& tcFactory, const std::string& name, const json& curve);
+static Ptr<TrafficClass> CreateTrafficClass(ObjectFactory& tcFactory, const json& queueConf);
+static std::string GetQueueType(const json& config, const std::string& source);
+static void ConfigureScheduler(Ptr<DiffServ> diffServ, const json& config);
+static void SetRoundRobinMode(Ptr<DrrQueue> drr, const json& config);
+static void ConfigureSpq(Ptr<StrictPriorityQueue> spq, const json& config);
+static void ConfigureLlq(Ptr<LlqQueue> llq, const json& config);
+static void ConfigurePifo(Ptr<PifoQueue> pifo, const json& config);
+static void ConfigureHtb(Ptr<HtbQueue> htb, const json& config);
+static void ConfigureEdf(Ptr<EdfQueue> edf, const json& config);
 
 /**
  * @brief Initialize a StrictPriorityQueue instance from a JSON config file.
@@ -39,7 +57,19 @@ static Ipv4Mask MakeIpv4MaskFromPrefixLength(uint8_t prefixLength);
 void
 QosInitializer::InitializeSpqFromJson(Ptr<StrictPriorityQueue> spq, const std::string& filepath)
 {
-    json config = LoadJson(filepath);
+    ConfigureSpq(spq, LoadJson(filepath));
+}
+
+/**
+ * @brief Configure a StrictPriorityQueue from a parsed JSON object.
+ *
+ * @param spq Pointer to the StrictPriorityQueue to be configured.
+ * @param config The JSON configuration, a whole file or a nested "child" object.
+ */
+static void
+ConfigureSpq(Ptr<StrictPriorityQueue> spq, const json& config)
+{
+    SetOptionalQueueAttributes(spq, config);
 
     for (const auto& queueConf : config["queues"])
     {
@@ -52,14 +82,9 @@ QosInitializer::InitializeSpqFromJson(Ptr<StrictPriorityQueue> spq, const std::s
         tcFactory.Set("isDefault", BooleanValue(isDefaultJson.get<bool>()));
         const auto& priorityLevelJson = queueConf["priorityLevel"];
         tcFactory.Set("priority_level", UintegerValue(priorityLevelJson.get<uint32_t>()));
+        SetOptionalClassAttributes(tcFactory, queueConf);
 
-        Ptr<TrafficClass> tc = DynamicCast<TrafficClass>(tcFactory.Create());
-
-        for (const auto& filterConf : queueConf["filters"])
-        {
-            Ptr<Filter> filter = CreateFilter(filterConf);
-            tc->AddFilter(filter);
-        }
+        Ptr<TrafficClass> tc = CreateTrafficClass(tcFactory, queueConf);
 
         spq->AddTrafficClass(tc);
     }
@@ -68,7 +93,8 @@ QosInitializer::InitializeSpqFromJson(Ptr<StrictPriorityQueue> spq, const std::s
 /**
  * @brief Initialize a DrrQueue instance from a JSON config file.
  *
- * Each TrafficClass is created with a weight, filters, and maxPackets value.
+ * Each TrafficClass is created with a weight, filters, and maxPackets value. The optional
+ * top-level "mode" is "Deficit" (default), "Surplus" or "WeightedRoundRobin".
  *
  * @param drr Pointer to the DrrQueue to be configured.
  * @param filepath Path to the JSON configuration file.
@@ -77,6 +103,300 @@ void
 QosInitializer::InitializeDrrFromJson(Ptr<DrrQueue> drr, const std::string& filepath)
 {
     json config = LoadJson(filepath);
+    SetOptionalQueueAttributes(drr, config);
+    SetRoundRobinMode(drr, config);
+    AddWeightedClasses(drr, config);
+}
+
+/**
+ * @brief Initialize a Wf2qQueue instance from a JSON config file.
+ *
+ * Uses the DRR format: each weight is the share of the link given to its class.
+ *
+ * @param wf2q Pointer to the Wf2qQueue to be configured.
+ * @param filepath Path to the JSON configuration file.
+ */
+void
+QosInitializer::InitializeWf2qFromJson(Ptr<Wf2qQueue> wf2q, const std::string& filepath)
+{
+    json config = LoadJson(filepath);
+    SetOptionalQueueAttributes(wf2q, config);
+    AddWeightedClasses(wf2q, config);
+}
+
+/**
+ * @brief Initialize a StfqQueue instance from a JSON config file.
+ *
+ * Uses the DRR format: each weight is the share of the link given to its class.
+ *
+ * @param stfq Pointer to the StfqQueue to be configured.
+ * @param filepath Path to the JSON configuration file.
+ */
+void
+QosInitializer::InitializeStfqFromJson(Ptr<StfqQueue> stfq, const std::string& filepath)
+{
+    json config = LoadJson(filepath);
+    SetOptionalQueueAttributes(stfq, config);
+    AddWeightedClasses(stfq, config);
+}
+
+/**
+ * @brief Initialize an EdfQueue instance from a JSON config file.
+ *
+ * Each queue's "delayBudget" sets the deadline of its packets. The optional top-level
+ * "dropExpired": true drops packets that are past their deadline when they are dequeued.
+ *
+ * @param edf Pointer to the EdfQueue to be configured.
+ * @param filepath Path to the JSON configuration file.
+ */
+void
+QosInitializer::InitializeEdfFromJson(Ptr<EdfQueue> edf, const std::string& filepath)
+{
+    ConfigureEdf(edf, LoadJson(filepath));
+}
+
+/**
+ * @brief Configure an EdfQueue from a parsed JSON object.
+ *
+ * @param edf Pointer to the EDF queue to be configured.
+ * @param config The JSON configuration, a whole file or a nested "child" object.
+ */
+static void
+ConfigureEdf(Ptr<EdfQueue> edf, const json& config)
+{
+    SetOptionalQueueAttributes(edf, config);
+    if (config.contains("dropExpired"))
+    {
+        edf->SetAttribute("DropExpired", BooleanValue(config["dropExpired"].get<bool>()));
+    }
+    AddClasses(edf, config);
+}
+
+/**
+ * @brief Initialize a VirtualClockQueue instance from a JSON config file.
+ *
+ * Uses the DRR format; a class reserves its "minRate" if it has one, else its weight in bytes
+ * per second.
+ *
+ * @param vc Pointer to the VirtualClockQueue to be configured.
+ * @param filepath Path to the JSON configuration file.
+ */
+void
+QosInitializer::InitializeVirtualClockFromJson(Ptr<VirtualClockQueue> vc,
+                                               const std::string& filepath)
+{
+    json config = LoadJson(filepath);
+    SetOptionalQueueAttributes(vc, config);
+    AddWeightedClasses(vc, config);
+}
+
+/**
+ * @brief Initialize a PifoQueue instance from a JSON config file.
+ *
+ * "rank" names the rank function by its TypeId without the "ns3::" prefix (StrictPriorityRank,
+ * StfqRank, EdfRank or LstfRank, default StrictPriorityRank), and the optional "rankAttributes"
+ * object sets its attributes, e.g. {"LinkRate": "1Mbps"}. Queues may give a "priorityLevel",
+ * a "weight" and a "delayBudget", whichever the rank function uses.
+ *
+ * @param pifo Pointer to the PifoQueue to be configured.
+ * @param filepath Path to the JSON configuration file.
+ */
+void
+QosInitializer::InitializePifoFromJson(Ptr<PifoQueue> pifo, const std::string& filepath)
+{
+    ConfigurePifo(pifo, LoadJson(filepath));
+}
+
+/**
+ * @brief Configure a PifoQueue from a parsed JSON object.
+ *
+ * @param pifo Pointer to the PIFO queue to be configured.
+ * @param config The JSON configuration, a whole file or a nested "child" object.
+ */
+static void
+ConfigurePifo(Ptr<PifoQueue> pifo, const json& config)
+{
+    SetOptionalQueueAttributes(pifo, config);
+
+    ObjectFactory rankFactory;
+    rankFactory.SetTypeId("ns3::" + config.value("rank", std::string("StrictPriorityRank")));
+    if (config.contains("rankAttributes"))
+    {
+        for (const auto& attribute : config["rankAttributes"].items())
+        {
+            rankFactory.Set(attribute.key(), StringValue(attribute.value().get<std::string>()));
+        }
+    }
+    pifo->SetRankFunction(DynamicCast<PifoRank>(rankFactory.Create()));
+
+    AddClasses(pifo, config);
+}
+
+/**
+ * @brief Initialize an HtbQueue instance, and the tree below it, from a JSON config file.
+ *
+ * Every queue takes an assured "rate" and optionally a "ceil" it may borrow up to, a
+ * "priorityLevel" and a "weight" (the quantum of its turns). A queue may hold a "child" object,
+ * itself a configuration with a "type" and "queues", whose scheduler then holds the queue's
+ * packets; children may be nested to any depth.
+ *
+ * @param htb Pointer to the HtbQueue to be configured.
+ * @param filepath Path to the JSON configuration file.
+ */
+void
+QosInitializer::InitializeHtbFromJson(Ptr<HtbQueue> htb, const std::string& filepath)
+{
+    ConfigureHtb(htb, LoadJson(filepath));
+}
+
+/**
+ * @brief Configure an HtbQueue from a parsed JSON object.
+ *
+ * @param htb Pointer to the HTB queue to be configured.
+ * @param config The JSON configuration, a whole file or a nested "child" object.
+ */
+static void
+ConfigureHtb(Ptr<HtbQueue> htb, const json& config)
+{
+    SetOptionalQueueAttributes(htb, config);
+    AddClasses(htb, config);
+}
+
+/**
+ * @brief Initialize an HfscQueue instance from a JSON config file.
+ *
+ * Queues may give a "realTime" and a "linkShare" service curve, each an object with the
+ * long-term rate "m2" and optionally a first segment of rate "m1" lasting "d", e.g.
+ * {"m1": "2Mbps", "d": "10ms", "m2": "100kbps"}. A queue without "linkShare" shares the
+ * bandwidth left over in proportion to its "weight".
+ *
+ * @param hfsc Pointer to the HfscQueue to be configured.
+ * @param filepath Path to the JSON configuration file.
+ */
+void
+QosInitializer::InitializeHfscFromJson(Ptr<HfscQueue> hfsc, const std::string& filepath)
+{
+    json config = LoadJson(filepath);
+    SetOptionalQueueAttributes(hfsc, config);
+    AddClasses(hfsc, config);
+}
+
+/**
+ * @brief Configure a scheduler of any type from a parsed JSON object.
+ *
+ * @param diffServ The scheduler, created from the TypeId that "type" maps to.
+ * @param config The JSON configuration.
+ */
+static void
+ConfigureScheduler(Ptr<DiffServ> diffServ, const json& config)
+{
+    const std::string& type = config["type"].get<std::string>();
+    if (type == "SPQ")
+    {
+        ConfigureSpq(DynamicCast<StrictPriorityQueue>(diffServ), config);
+    }
+    else if (type == "LLQ")
+    {
+        ConfigureLlq(DynamicCast<LlqQueue>(diffServ), config);
+    }
+    else if (type == "PIFO")
+    {
+        ConfigurePifo(DynamicCast<PifoQueue>(diffServ), config);
+    }
+    else if (type == "HTB")
+    {
+        ConfigureHtb(DynamicCast<HtbQueue>(diffServ), config);
+    }
+    else if (type == "EDF")
+    {
+        ConfigureEdf(DynamicCast<EdfQueue>(diffServ), config);
+    }
+    else if (type == "DRR")
+    {
+        SetOptionalQueueAttributes(diffServ, config);
+        SetRoundRobinMode(DynamicCast<DrrQueue>(diffServ), config);
+        AddWeightedClasses(diffServ, config);
+    }
+    else if (type == "HFSC")
+    {
+        SetOptionalQueueAttributes(diffServ, config);
+        AddClasses(diffServ, config);
+    }
+    else
+    {
+        // WF2Q, STFQ and VC share the DRR format
+        SetOptionalQueueAttributes(diffServ, config);
+        AddWeightedClasses(diffServ, config);
+    }
+}
+
+/**
+ * @brief Look up the scheduler a configuration file asks for.
+ *
+ * @param filepath Path to the JSON configuration file.
+ * @return The TypeId name of the DiffServ subclass named by "type".
+ */
+std::string
+QosInitializer::GetQueueTypeFromJson(const std::string& filepath)
+{
+    return GetQueueType(LoadJson(filepath), filepath);
+}
+
+/**
+ * @brief Map the "type" field of a JSON configuration to the TypeId name of its scheduler.
+ *
+ * @param config The JSON configuration.
+ * @param source Where the configuration comes from, for the error message.
+ * @return The TypeId name of the DiffServ subclass named by "type".
+ */
+static std::string
+GetQueueType(const json& config, const std::string& source)
+{
+    static const std::map<std::string, std::string> types = {
+        {"SPQ", "ns3::StrictPriorityQueue<Packet>"},
+        {"DRR", "ns3::DrrQueue<Packet>"},
+        {"LLQ", "ns3::LlqQueue<Packet>"},
+        {"WF2Q", "ns3::Wf2qQueue<Packet>"},
+        {"STFQ", "ns3::StfqQueue<Packet>"},
+        {"PIFO", "ns3::PifoQueue<Packet>"},
+        {"HTB", "ns3::HtbQueue<Packet>"},
+        {"HFSC", "ns3::HfscQueue<Packet>"},
+        {"VC", "ns3::VirtualClockQueue<Packet>"},
+        {"EDF", "ns3::EdfQueue<Packet>"},
+    };
+
+    const std::string& type = config["type"].get<std::string>();
+    auto it = types.find(type);
+    NS_ABORT_MSG_IF(it == types.end(), "Unknown scheduler type \"" << type << "\" in " << source);
+    return it->second;
+}
+
+/**
+ * @brief Initialize an LlqQueue instance from a JSON config file.
+ *
+ * Queues with "lowLatency": true take a "priorityLevel" and are normally policed with
+ * "policeRate"/"policeBurst"; every other queue takes a DRR "weight".
+ *
+ * @param llq Pointer to the LlqQueue to be configured.
+ * @param filepath Path to the JSON configuration file.
+ */
+void
+QosInitializer::InitializeLlqFromJson(Ptr<LlqQueue> llq, const std::string& filepath)
+{
+    ConfigureLlq(llq, LoadJson(filepath));
+}
+
+/**
+ * @brief Configure an LlqQueue from a parsed JSON object.
+ *
+ * @param llq Pointer to the LLQ queue to be configured.
+ * @param config The JSON configuration, a whole file or a nested "child" object.
+ */
+static void
+ConfigureLlq(Ptr<LlqQueue> llq, const json& config)
+{
+    SetOptionalQueueAttributes(llq, config);
+    SetRoundRobinMode(llq, config);
 
     for (const auto& queueConf : config["queues"])
     {
@@ -87,19 +407,118 @@ QosInitializer::InitializeDrrFromJson(Ptr<DrrQueue> drr, const std::string& file
         tcFactory.Set("maxPackets", UintegerValue(maxPacketsJson.get<uint32_t>()));
         const auto& isDefaultJson = queueConf["isDefault"];
         tcFactory.Set("isDefault", BooleanValue(isDefaultJson.get<bool>()));
-        const auto& weightJson = queueConf["weight"];
-        tcFactory.Set("weight", UintegerValue(weightJson.get<uint32_t>()));
+        if (queueConf.value("lowLatency", false))
+        {
+            const auto& priorityLevelJson = queueConf["priorityLevel"];
+            tcFactory.Set("priority_level", UintegerValue(priorityLevelJson.get<uint32_t>()));
+        }
+        else
+        {
+            tcFactory.Set("weight", UintegerValue(GetWeight(queueConf)));
+        }
+        SetOptionalClassAttributes(tcFactory, queueConf);
+
+        Ptr<TrafficClass> tc = CreateTrafficClass(tcFactory, queueConf);
+
+        llq->AddTrafficClass(tc);
+    }
+}
 
-        Ptr<TrafficClass> tc = DynamicCast<TrafficClass>(tcFactory.Create());
+/**
+ * @brief Create the traffic classes listed under "queues", each with an optional
+ *        "priorityLevel" and "weight", and add them to a scheduler.
+ *
+ * @param diffServ The scheduler to add the classes to.
+ * @param config The whole JSON configuration.
+ */
+static void
+AddClasses(Ptr<DiffServ> diffServ, const json& config)
+{
+    for (const auto& queueConf : config["queues"])
+    {
+        ObjectFactory tcFactory;
+        tcFactory.SetTypeId("ns3::TrafficClass");
 
-        for (const auto& filterConf : queueConf["filters"])
+        const auto& maxPacketsJson = queueConf["maxPackets"];
+        tcFactory.Set("maxPackets", UintegerValue(maxPacketsJson.get<uint32_t>()));
+        const auto& isDefaultJson = queueConf["isDefault"];
+        tcFactory.Set("isDefault", BooleanValue(isDefaultJson.get<bool>()));
+        if (queueConf.contains("priorityLevel"))
+        {
+            const auto& priorityLevelJson = queueConf["priorityLevel"];
+            tcFactory.Set("priority_level", UintegerValue(priorityLevelJson.get<uint32_t>()));
+        }
+        if (queueConf.contains("weight"))
         {
-            Ptr<Filter> filter = CreateFilter(filterConf);
-            tc->AddFilter(filter);
+            tcFactory.Set("weight", UintegerValue(GetWeight(queueConf)));
         }
+        SetOptionalClassAttributes(tcFactory, queueConf);
+
+        Ptr<TrafficClass> tc = CreateTrafficClass(tcFactory, queueConf);
+
+        diffServ->AddTrafficClass(tc);
+    }
+}
 
-        drr->AddTrafficClass(tc);
+/**
+ * @brief Create the weighted traffic classes listed under "queues" and add them to a scheduler.
+ *
+ * @param diffServ The scheduler to add the classes to.
+ * @param config The whole JSON configuration.
+ */
+static void
+AddWeightedClasses(Ptr<DiffServ> diffServ, const json& config)
+{
+    for (const auto& queueConf : config["queues"])
+    {
+        ObjectFactory tcFactory;
+        tcFactory.SetTypeId("ns3::TrafficClass");
+
+        const auto& maxPacketsJson = queueConf["maxPackets"];
+        tcFactory.Set("maxPackets", UintegerValue(maxPacketsJson.get<uint32_t>()));
+        const auto& isDefaultJson = queueConf["isDefault"];
+        tcFactory.Set("isDefault", BooleanValue(isDefaultJson.get<bool>()));
+        tcFactory.Set("weight", UintegerValue(GetWeight(queueConf)));
+        SetOptionalClassAttributes(tcFactory, queueConf);
+
+        Ptr<TrafficClass> tc = CreateTrafficClass(tcFactory, queueConf);
+
+        diffServ->AddTrafficClass(tc);
+    }
+}
+
+/**
+ * @brief Create a TrafficClass from its factory and add the filters of its queue entry.
+ *
+ * When the entry has a "child" object, the scheduler it describes is created, configured and
+ * set as the child of the class. Children are not initialized as ns-3 objects, so they never
+ * look for a "Config" file of their own.
+ *
+ * @param tcFactory Factory holding the class attributes.
+ * @param queueConf JSON object describing one queue.
+ * @return The traffic class.
+ */
+static Ptr<TrafficClass>
+CreateTrafficClass(ObjectFactory& tcFactory, const json& queueConf)
+{
+    Ptr<TrafficClass> tc = DynamicCast<TrafficClass>(tcFactory.Create());
+
+    for (const auto& filterConf : queueConf["filters"])
+    {
+        Ptr<Filter> filter = CreateFilter(filterConf);
+        tc->AddFilter(filter);
+    }
+
+    if (queueConf.contains("child"))
+    {
+        const json& childConf = queueConf["child"];
+        ObjectFactory childFactory;
+        childFactory.SetTypeId(GetQueueType(childConf, queueConf.dump()));
+        Ptr<DiffServ> child = DynamicCast<DiffServ>(childFactory.Create());
+        ConfigureScheduler(child, childConf);
+        tc->SetChild(child);
     }
+    return tc;
 }
 
 /**
@@ -168,6 +587,179 @@ CreateFilterElement(const json& filterElementConf)
     return filterElement;
 }
 
+/**
+ * @brief Apply the per-class settings that may be omitted from a queue entry.
+ *
+ * Supported keys: "useEcn" (bool), "congestionThreshold" (packets), "rate" (e.g. "500kbps"),
+ * "burst" (bytes), and for flow queue mode "flowQueues" (sub-queue count), "flowQuantum"
+ * (bytes), "useCodel" (bool), "codelTarget" and "codelInterval" (e.g. "5ms"), and for SPQ
+ * starvation protection "minRate" (e.g. "100kbps") and "maxWait" (e.g. "200ms"), and for LLQ
+ * "lowLatency" (bool), "policeRate" (e.g. "1Mbps") and "policeBurst" (bytes), for deadline
+ * schedulers "delayBudget" (e.g. "20ms"), for HTB "ceil" (e.g. "1Mbps"), and for HFSC the
+ * "realTime" and "linkShare" service curves.
+ *
+ * @param tcFactory Factory of the TrafficClass being configured.
+ * @param queueConf JSON object describing one queue.
+ */
+static void
+SetOptionalClassAttributes(ObjectFactory& tcFactory, const json& queueConf)
+{
+    if (queueConf.contains("useEcn"))
+    {
+        tcFactory.Set("useEcn", BooleanValue(queueConf["useEcn"].get<bool>()));
+    }
+    if (queueConf.contains("congestionThreshold"))
+    {
+        tcFactory.Set("congestionThreshold",
+                      UintegerValue(queueConf["congestionThreshold"].get<uint32_t>()));
+    }
+    if (queueConf.contains("rate"))
+    {
+        tcFactory.Set("rate", DataRateValue(DataRate(queueConf["rate"].get<std::string>())));
+    }
+    if (queueConf.contains("burst"))
+    {
+        tcFactory.Set("burst", UintegerValue(queueConf["burst"].get<uint32_t>()));
+    }
+    if (queueConf.contains("ceil"))
+    {
+        tcFactory.Set("ceil", DataRateValue(DataRate(queueConf["ceil"].get<std::string>())));
+    }
+    if (queueConf.contains("flowQueues"))
+    {
+        tcFactory.Set("flowQueues", UintegerValue(queueConf["flowQueues"].get<uint32_t>()));
+    }
+    if (queueConf.contains("flowQuantum"))
+    {
+        tcFactory.Set("flowQuantum", UintegerValue(queueConf["flowQuantum"].get<uint32_t>()));
+    }
+    if (queueConf.contains("useCodel"))
+    {
+        tcFactory.Set("useCodel", BooleanValue(queueConf["useCodel"].get<bool>()));
+    }
+    if (queueConf.contains("codelTarget"))
+    {
+        tcFactory.Set("codelTarget", TimeValue(Time(queueConf["codelTarget"].get<std::string>())));
+    }
+    if (queueConf.contains("codelInterval"))
+    {
+        tcFactory.Set("codelInterval",
+                      TimeValue(Time(queueConf["codelInterval"].get<std::string>())));
+    }
+    if (queueConf.contains("minRate"))
+    {
+        tcFactory.Set("minRate", DataRateValue(DataRate(queueConf["minRate"].get<std::string>())));
+    }
+    if (queueConf.contains("maxWait"))
+    {
+        tcFactory.Set("maxWait", TimeValue(Time(queueConf["maxWait"].get<std::string>())));
+    }
+    if (queueConf.contains("lowLatency"))
+    {
+        tcFactory.Set("lowLatency", BooleanValue(queueConf["lowLatency"].get<bool>()));
+    }
+    if (queueConf.contains("policeRate"))
+    {
+        tcFactory.Set("policeRate",
+                      DataRateValue(DataRate(queueConf["policeRate"].get<std::string>())));
+    }
+    if (queueConf.contains("policeBurst"))
+    {
+        tcFactory.Set("policeBurst", UintegerValue(queueConf["policeBurst"].get<uint32_t>()));
+    }
+    if (queueConf.contains("delayBudget"))
+    {
+        tcFactory.Set("delayBudget",
+                      TimeValue(Time(queueConf["delayBudget"].get<std::string>())));
+    }
+    if (queueConf.contains("realTime"))
+    {
+        SetServiceCurve(tcFactory, "realTime", queueConf["realTime"]);
+    }
+    if (queueConf.contains("linkShare"))
+    {
+        SetServiceCurve(tcFactory, "linkShare", queueConf["linkShare"]);
+    }
+}
+
+/**
+ * @brief Set the attributes of a two-piece service curve from its JSON object.
+ *
+ * @param tcFactory Factory of the TrafficClass being configured.
+ * @param name Attribute prefix, "realTime" or "linkShare".
+ * @param curve JSON object with "m2" and optionally "m1" and "d".
+ */
+static void
+SetServiceCurve(ObjectFactory& tcFactory, const std::string& name, const json& curve)
+{
+    tcFactory.Set(name + "M2", DataRateValue(DataRate(curve["m2"].get<std::string>())));
+    if (curve.contains("m1"))
+    {
+        tcFactory.Set(name + "M1", DataRateValue(DataRate(curve["m1"].get<std::string>())));
+    }
+    if (curve.contains("d"))
+    {
+        tcFactory.Set(name + "D", TimeValue(Time(curve["d"].get<std::string>())));
+    }
+}
+
+/**
+ * @brief Apply the scheduler-wide settings that may be omitted from a configuration file.
+ *
+ * Supported keys: "sharedLimit" (packets shared by all queues), "pushOut" ("None",
+ * "LongestQueue" or "LowestPriority") and "bypass" (whether idle arrivals skip the scheduler).
+ *
+ * @param diffServ The DiffServ queue being configured.
+ * @param config The whole JSON configuration.
+ */
+static void
+SetOptionalQueueAttributes(Ptr<DiffServ> diffServ, const json& config)
+{
+    if (config.contains("sharedLimit"))
+    {
+        diffServ->SetAttribute("SharedLimit",
+                               UintegerValue(config["sharedLimit"].get<uint32_t>()));
+    }
+    if (config.contains("pushOut"))
+    {
+        diffServ->SetAttribute("PushOut", StringValue(config["pushOut"].get<std::string>()));
+    }
+    if (config.contains("bypass"))
+    {
+        diffServ->SetAttribute("Bypass", BooleanValue(config["bypass"].get<bool>()));
+    }
+}
+
+/**
+ * @brief Apply the optional "mode" of a DRR-based scheduler, "Deficit", "Surplus" or
+ *        "WeightedRoundRobin".
+ *
+ * @param drr The DRR or LLQ queue being configured.
+ * @param config The whole JSON configuration.
+ */
+static void
+SetRoundRobinMode(Ptr<DrrQueue> drr, const json& config)
+{
+    if (config.contains("mode"))
+    {
+        drr->SetAttribute("Mode", StringValue(config["mode"].get<std::string>()));
+    }
+}
+
+/**
+ * @brief Read the DRR quantum of a queue, rejecting a zero weight that could never send.
+ *
+ * @param queueConf JSON object describing one queue.
+ * @return The weight in bytes.
+ */
+static uint32_t
+GetWeight(const json& queueConf)
+{
+    uint32_t weight = queueConf["weight"].get<uint32_t>();
+    NS_ABORT_MSG_IF(weight == 0, "DRR weight must be at least one byte: " << queueConf.dump());
+    return weight;
+}
+
 /** Helper function scoped only in this file, load a json object from filepath */
 static json
 LoadJson(const std::string& filepath)
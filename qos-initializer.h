@@ -10,7 +10,15 @@
 #define QOS_INITIALIZER
 
 #include "./drr-queue.h"
+#include "./edf-queue.h"
+#include "./hfsc-queue.h"
+#include "./htb-queue.h"
+#include "./llq-queue.h"
+#include "./pifo-queue.h"
 #include "./spq.h"
+#include "./stfq-queue.h"
+#include "./virtual-clock-queue.h"
+#include "./wf2q-queue.h"
 
 namespace ns3
 {
@@ -37,6 +45,75 @@ class QosInitializer
      * @param filepath Absolute or relative path to the JSON configuration file.
      */
     static void InitializeDrrFromJson(Ptr<DrrQueue> drr, const std::string& filepath);
+
+    /**
+     * @brief Initializes an LlqQueue using a JSON config file.
+     * @param llq Pointer to the LLQ queue object.
+     * @param filepath Absolute or relative path to the JSON configuration file.
+     */
+    static void InitializeLlqFromJson(Ptr<LlqQueue> llq, const std::string& filepath);
+
+    /**
+     * @brief Initializes a Wf2qQueue using a JSON config file in the DRR format.
+     * @param wf2q Pointer to the WF2Q+ queue object.
+     * @param filepath Absolute or relative path to the JSON configuration file.
+     */
+    static void InitializeWf2qFromJson(Ptr<Wf2qQueue> wf2q, const std::string& filepath);
+
+    /**
+     * @brief Initializes a StfqQueue using a JSON config file.
+     * @param stfq Pointer to the STFQ queue object.
+     * @param filepath Absolute or relative path to the JSON configuration file.
+     */
+    static void InitializeStfqFromJson(Ptr<StfqQueue> stfq, const std::string& filepath);
+
+    /**
+     * @brief Initializes a PifoQueue and its rank function using a JSON config file.
+     * @param pifo Pointer to the PIFO queue object.
+     * @param filepath Absolute or relative path to the JSON configuration file.
+     */
+    static void InitializePifoFromJson(Ptr<PifoQueue> pifo, const std::string& filepath);
+
+    /**
+     * @brief Initializes an HtbQueue, and the child schedulers nested in its queues, using a
+     *        JSON config file.
+     * @param htb Pointer to the HTB queue object.
+     * @param filepath Absolute or relative path to the JSON configuration file.
+     */
+    static void InitializeHtbFromJson(Ptr<HtbQueue> htb, const std::string& filepath);
+
+    /**
+     * @brief Initializes an HfscQueue using a JSON config file.
+     * @param hfsc Pointer to the HFSC queue object.
+     * @param filepath Absolute or relative path to the JSON configuration file.
+     */
+    static void InitializeHfscFromJson(Ptr<HfscQueue> hfsc, const std::string& filepath);
+
+    /**
+     * @brief Initializes an EdfQueue using a JSON config file.
+     * @param edf Pointer to the EDF queue object.
+     * @param filepath Absolute or relative path to the JSON configuration file.
+     */
+    static void InitializeEdfFromJson(Ptr<EdfQueue> edf, const std::string& filepath);
+
+    /**
+     * @brief Initializes a VirtualClockQueue using a JSON config file in the DRR format.
+     * @param vc Pointer to the Virtual Clock queue object.
+     * @param filepath Absolute or relative path to the JSON configuration file.
+     */
+    static void InitializeVirtualClockFromJson(Ptr<VirtualClockQueue> vc,
+                                               const std::string& filepath);
+
+    /**
+     * @brief Map the "type" field of a JSON config file to the TypeId name of its scheduler.
+     *
+     * Known types are "SPQ", "DRR", "LLQ", "WF2Q", "STFQ", "PIFO", "HTB", "HFSC", "VC" and
+     * "EDF"; any other value aborts.
+     *
+     * @param filepath Absolute or relative path to the JSON configuration file.
+     * @return The TypeId name to pass to e.g. PointToPointHelper::SetQueue.
+     */
+    static std::string GetQueueTypeFromJson(const std::string& filepath);
 };
 } // namespace ns3
 
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "service-curve.h"
+
+#include <limits>
+
+namespace ns3
+{
+
+ServiceCurve::ServiceCurve()
+    : m_m1(0),
+      m_d(0),
+      m_m2(0),
+      m_x(0),
+      m_y(0),
+      m_dx(0),
+      m_dy(0)
+{
+}
+
+ServiceCurve::ServiceCurve(DataRate m1, Time d, DataRate m2)
+    : m_m1(m1.GetBitRate() / 8.0),
+      m_d(d.GetSeconds()),
+      m_m2(m2.GetBitRate() / 8.0)
+{
+    Anchor(0, 0);
+}
+
+bool
+ServiceCurve::IsZero() const
+{
+    return m_m1 == 0 && m_m2 == 0;
+}
+
+bool
+ServiceCurve::IsConcave() const
+{
+    return m_m1 > m_m2;
+}
+
+void
+ServiceCurve::Anchor(double x, double y)
+{
+    m_x = x;
+    m_y = y;
+    m_dx = m_d;
+    m_dy = m_m1 * m_d;
+}
+
+/**
+ * @brief A convex curve is simply moved to the new point if that lowers it. A concave curve
+ *        is kept if it is already below the new one, replaced if it is above it over the whole
+ *        first segment, and otherwise restarted at the new point with the first segment cut
+ *        where the two curves cross.
+ */
+void
+ServiceCurve::Min(double x, double y)
+{
+    if (m_m1 <= m_m2)
+    {
+        if (GetY(x) < y)
+        {
+            return;
+        }
+        m_x = x;
+        m_y = y;
+        return;
+    }
+
+    double y1 = GetY(x);
+    if (y1 <= y)
+    {
+        return;
+    }
+
+    double y2 = GetY(x + m_d);
+    if (y2 >= y + m_m1 * m_d)
+    {
+        Anchor(x, y);
+        return;
+    }
+
+    // The steep segment from (x, y) catches up with the current curve after dx
+    double dx = (y1 - y) / (m_m1 - m_m2);
+    if (m_x + m_dx > x)
+    {
+        dx += m_x + m_dx - x; // (x, y1) lies on the current first segment
+    }
+    m_x = x;
+    m_y = y;
+    m_dx = dx;
+    m_dy = m_m1 * dx;
+}
+
+void
+ServiceCurve::DropFirstSegment()
+{
+    m_dx = 0;
+    m_dy = 0;
+}
+
+double
+ServiceCurve::GetY(double x) const
+{
+    if (x <= m_x)
+    {
+        return m_y;
+    }
+    if (x <= m_x + m_dx)
+    {
+        return m_y + m_m1 * (x - m_x);
+    }
+    return m_y + m_dy + m_m2 * (x - m_x - m_dx);
+}
+
+double
+ServiceCurve::GetX(double y) const
+{
+    if (y < m_y)
+    {
+        return m_x;
+    }
+    if (y <= m_y + m_dy)
+    {
+        return m_dy == 0 ? m_x + m_dx : m_x + (y - m_y) / m_m1;
+    }
+    if (m_m2 == 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return m_x + m_dx + (y - m_y - m_dy) / m_m2;
+}
+
+} // namespace ns3
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef SERVICE_CURVE_H
+#define SERVICE_CURVE_H
+
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+
+namespace ns3
+{
+
+/**
+ * @brief Two-piece linear service curve, as used by HFSC.
+ *
+ * The curve has slope m1 for its first d seconds and slope m2 afterwards; m1 > m2 makes it
+ * concave (a burst, decoupling delay from rate), m1 < m2 convex. Besides this shape, an object
+ * holds a runtime position: the point (x, y) in seconds and bytes where the curve currently
+ * starts and the extent (dx, dy) of its first segment. Anchor places the full curve at a point,
+ * and Min lowers the curve to the minimum of itself and the full curve placed at a new point,
+ * which is how HFSC restarts the deadline and virtual curves of a class that becomes active.
+ */
+class ServiceCurve
+{
+  public:
+    /**
+     * @brief Create the zero curve, which provides no service.
+     */
+    ServiceCurve();
+
+    /**
+     * @brief Create a curve anchored at the origin.
+     *
+     * @param m1 Slope of the first segment.
+     * @param d Length of the first segment.
+     * @param m2 Slope of the second segment.
+     */
+    ServiceCurve(DataRate m1, Time d, DataRate m2);
+
+    /**
+     * @brief Check whether the curve provides no service at all.
+     *
+     * @return true if both slopes are zero.
+     */
+    bool IsZero() const;
+
+    /**
+     * @brief Check whether the first segment is steeper than the second.
+     *
+     * @return true if m1 > m2.
+     */
+    bool IsConcave() const;
+
+    /**
+     * @brief Start the full curve at a point.
+     *
+     * @param x Time in seconds.
+     * @param y Service in bytes.
+     */
+    void Anchor(double x, double y);
+
+    /**
+     * @brief Lower the curve to the minimum of itself and the full curve started at a point.
+     *
+     * @param x Time in seconds, not before the current start of the curve.
+     * @param y Service in bytes.
+     */
+    void Min(double x, double y);
+
+    /**
+     * @brief Drop the first segment, leaving only slope m2 from the current start.
+     *
+     * HFSC uses this for the eligible curve of a convex real-time curve, so that the class
+     * becomes eligible early enough to meet the steeper second segment.
+     */
+    void DropFirstSegment();
+
+    /**
+     * @brief Evaluate the curve.
+     *
+     * @param x Time in seconds.
+     * @return Service in bytes the curve grants by then.
+     */
+    double GetY(double x) const;
+
+    /**
+     * @brief Invert the curve.
+     *
+     * @param y Service in bytes.
+     * @return Earliest time in seconds at which the curve reaches it, infinity if never.
+     */
+    double GetX(double y) const;
+
+  private:
+    double m_m1; //!< Slope of the first segment in bytes per second
+    double m_d;  //!< Length of the first segment in seconds
+    double m_m2; //!< Slope of the second segment in bytes per second
+    double m_x;  //!< Time the curve starts at
+    double m_y;  //!< Service at m_x
+    double m_dx; //!< Length of the current first segment in seconds
+    double m_dy; //!< Service over the current first segment in bytes
+};
+
+} // namespace ns3
+
+#endif // SERVICE_CURVE_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "sojourn-histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+SojournHistogram::SojournHistogram()
+{
+    Reset();
+}
+
+/**
+ * @brief Add one sample to its bucket in constant time.
+ *
+ * @param sojourn The measured sojourn time.
+ */
+void
+SojournHistogram::Record(Time sojourn)
+{
+    uint64_t value = sojourn.IsStrictlyPositive() ? sojourn.GetNanoSeconds() : 0;
+    value = std::min<uint64_t>(value, (uint64_t(1) << MAX_VALUE_BITS) - 1);
+
+    m_counts[GetBucketIndex(value)]++;
+    m_total++;
+    m_max = std::max(m_max, value);
+}
+
+/**
+ * @brief Returns the number of recorded samples.
+ */
+uint64_t
+SojournHistogram::GetCount() const
+{
+    return m_total;
+}
+
+/**
+ * @brief Walk the buckets until the requested fraction of samples is covered.
+ *
+ * @param quantile Fraction of samples, e.g. 0.5 for the median.
+ * @return The representative value of the bucket holding that sample.
+ */
+Time
+SojournHistogram::GetPercentile(double quantile) const
+{
+    if (m_total == 0)
+    {
+        return Time(0);
+    }
+
+    quantile = std::clamp(quantile, 0.0, 1.0);
+    uint64_t rank = std::max<uint64_t>(1, std::ceil(quantile * m_total));
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += m_counts[i];
+        if (seen >= rank)
+        {
+            return NanoSeconds(std::min(GetBucketValue(i), m_max));
+        }
+    }
+    return NanoSeconds(m_max);
+}
+
+/**
+ * @brief Returns the largest recorded sample.
+ */
+Time
+SojournHistogram::GetMax() const
+{
+    return NanoSeconds(m_max);
+}
+
+/**
+ * @brief Clear all buckets.
+ */
+void
+SojournHistogram::Reset()
+{
+    m_counts.fill(0);
+    m_total = 0;
+    m_max = 0;
+}
+
+/**
+ * @brief Values below 2 * SUB_BUCKETS map linearly; above that, the position of the highest set
+ *        bit selects the octave and the next SUB_BUCKET_BITS bits select the sub-bucket.
+ */
+uint32_t
+SojournHistogram::GetBucketIndex(uint64_t value)
+{
+    if (value < SUB_BUCKETS)
+    {
+        return value;
+    }
+
+    uint32_t msb = 63 - __builtin_clzll(value);
+    uint32_t octave = msb - SUB_BUCKET_BITS + 1;
+    uint32_t subBucket = (value >> (msb - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+    return octave * SUB_BUCKETS + subBucket;
+}
+
+/**
+ * @brief Inverse of GetBucketIndex, returning the middle of the bucket's value range.
+ */
+uint64_t
+SojournHistogram::GetBucketValue(uint32_t index)
+{
+    uint32_t octave = index / SUB_BUCKETS;
+    uint64_t subBucket = index % SUB_BUCKETS;
+    if (octave == 0)
+    {
+        return subBucket;
+    }
+
+    uint32_t shift = octave - 1;
+    uint64_t lower = (SUB_BUCKETS + subBucket) << shift;
+    return lower + ((uint64_t(1) << shift) >> 1);
+}
+
+} // namespace ns3
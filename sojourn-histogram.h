@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef SOJOURN_HISTOGRAM_H
+#define SOJOURN_HISTOGRAM_H
+
+#include "ns3/nstime.h"
+
+#include <array>
+
+namespace ns3
+{
+
+/**
+ * @brief Fixed-size log-linear (HDR-style) histogram of queueing delays.
+ *
+ * Delays are recorded in nanoseconds. Each power of two is split into 2^SUB_BUCKET_BITS linear
+ * sub-buckets, so any recorded value is reported within about 3% of its true value. Recording
+ * is O(1) and the memory footprint does not depend on the number of samples.
+ */
+class SojournHistogram
+{
+  public:
+    /**
+     * @brief Create an empty histogram.
+     */
+    SojournHistogram();
+
+    /**
+     * @brief Record one sojourn time.
+     *
+     * @param sojourn Time the packet spent in the queue; values beyond the range saturate.
+     */
+    void Record(Time sojourn);
+
+    /**
+     * @brief Get the number of recorded samples.
+     *
+     * @return The sample count.
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * @brief Get the value below which the given fraction of samples fall.
+     *
+     * @param quantile Fraction in [0, 1], e.g. 0.99 for p99.
+     * @return The estimated sojourn time, or zero if nothing was recorded.
+     */
+    Time GetPercentile(double quantile) const;
+
+    /**
+     * @brief Get the largest recorded sojourn time.
+     *
+     * @return The maximum, exact up to the saturation limit.
+     */
+    Time GetMax() const;
+
+    /**
+     * @brief Discard all samples, e.g. at the start of a new measurement period.
+     */
+    void Reset();
+
+  private:
+    static constexpr uint32_t SUB_BUCKET_BITS = 5;                  //!< 32 sub-buckets per octave
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;  //!< Sub-buckets per octave
+    static constexpr uint32_t MAX_VALUE_BITS = 40;                  //!< Up to ~18 minutes in ns
+    static constexpr uint32_t BUCKETS =
+        (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS; //!< Total number of buckets
+
+    /**
+     * @brief Map a value in nanoseconds to its bucket.
+     *
+     * @param value The value to map.
+     * @return The bucket index.
+     */
+    static uint32_t GetBucketIndex(uint64_t value);
+
+    /**
+     * @brief Get the representative (midpoint) value of a bucket.
+     *
+     * @param index The bucket index.
+     * @return The value in nanoseconds.
+     */
+    static uint64_t GetBucketValue(uint32_t index);
+
+    std::array<uint64_t, BUCKETS> m_counts; //!< Samples per bucket
+    uint64_t m_total;                       //!< Total number of samples
+    uint64_t m_max;                         //!< Largest sample in nanoseconds
+};
+
+} // namespace ns3
+
+#endif // SOJOURN_HISTOGRAM_H
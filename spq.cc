@@ -2,6 +2,7 @@
 
 #include "qos-initializer.h"
 
+#include "ns3/simulator.h"
 #include "ns3/string.h"
 
 namespace ns3
@@ -54,26 +55,7 @@ StrictPriorityQueue::DoInitialize()
 int32_t
 StrictPriorityQueue::Classify(Ptr<Packet> p)
 {
-    const auto& q_class = GetTrafficClasses();
-    for (int i = 0; i < q_class.size(); i++)
-    {
-        Ptr<TrafficClass> queue_class = q_class[i];
-        if (queue_class->Match(p))
-        {
-            return i;
-        }
-    }
-
-    // If a packet doesn't match any of the queue, place it in the default queue
-    for (int i = 0; i < q_class.size(); i++)
-    {
-        Ptr<TrafficClass> queue_class = q_class[i];
-        if (queue_class->IsDefault())
-        {
-            return i;
-        }
-    }
-    return -1;
+    return ClassifyByFilters(p);
 }
 
 /**
@@ -86,16 +68,12 @@ StrictPriorityQueue::Classify(Ptr<Packet> p)
 Ptr<Packet>
 StrictPriorityQueue::Schedule()
 {
-    int scheduleIndex = GetQueueForSchedule();
-    if (scheduleIndex == -1)
+    Ptr<Packet> p = ServeSelection();
+    if (!p)
     {
         NS_LOG_UNCOND("No non-empty queue found, returning nullptr");
-        return nullptr;
     }
-
-    const std::vector<Ptr<TrafficClass>>& classes = GetTrafficClasses();
-    Ptr<TrafficClass> tc = classes[scheduleIndex];
-    return tc->Dequeue();
+    return p;
 }
 
 /**
@@ -116,25 +94,40 @@ StrictPriorityQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
               [](const Ptr<TrafficClass> a, const Ptr<TrafficClass> b) {
                   return a->GetPriorityLevel() > b->GetPriorityLevel(); // descending order
               });
+    ResetClassState();
+
+    uint32_t n = q_class.size();
+    m_urgentClasses.Reset();
+    m_guaranteeTimers.resize(n);
+    m_credit.assign(n, 0);
+    m_creditUpdated.assign(n, Time(0));
 }
 
 /**
  * @brief Finds the index of the highest-priority non-empty traffic class.
  *
- * Used by the scheduler to determine which queue should be dequeued next.
+ * Used by the scheduler to determine which queue should be dequeued next. Classes whose minimum
+ * rate or head-of-line waiting bound has come due are served first, highest priority first.
+ * Otherwise classes are sorted by descending priority, so the first set bit of the active class
+ * bitmap is the answer, found with count-leading-zeros in constant time. Classes that are out
+ * of tokens are skipped so a rate-capped class cannot take the whole link.
  *
- * @return Index of the selected traffic class, or -1 if all queues are empty.
+ * @return Index of the selected traffic class, or -1 if all queues are empty or shaped.
  */
 int32_t
 StrictPriorityQueue::GetQueueForSchedule() const
 {
-    const auto& q_class = GetTrafficClasses();
-
-    for (uint32_t i = 0; i < q_class.size(); ++i)
+    for (int32_t i = m_urgentClasses.FindFirst(); i >= 0; i = m_urgentClasses.FindNext(i))
     {
-        Ptr<TrafficClass> queue_class = q_class[i];
+        if (IsEligible(i))
+        {
+            return i;
+        }
+    }
 
-        if (queue_class->GetPackets() > 0)
+    for (int32_t i = m_activeClasses.FindFirst(); i >= 0; i = m_activeClasses.FindNext(i))
+    {
+        if (IsEligible(i))
         {
             return i;
         }
@@ -142,4 +135,152 @@ StrictPriorityQueue::GetQueueForSchedule() const
     return -1;
 }
 
+/**
+ * @brief Start measuring the guarantee of a class when it becomes backlogged.
+ *
+ * @param index Index of the class that received a packet.
+ */
+void
+StrictPriorityQueue::NotifyEnqueue(uint32_t index)
+{
+    if (m_backlogs[index] == 1)
+    {
+        m_urgentClasses.Clear(index);
+        m_credit[index] = 0;
+        m_creditUpdated[index] = Simulator::Now();
+        ArmGuaranteeTimer(index);
+    }
+}
+
+/**
+ * @brief Account a served packet against the guarantee and re-arm the timer for the new head.
+ *
+ * Any service, urgent or not, satisfies the guarantee, so the credit never goes below zero.
+ *
+ * @param index Index of the class that was served.
+ * @param bytes Bytes sent.
+ */
+void
+StrictPriorityQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    RefreshCredit(index);
+    m_credit[index] = std::max(0.0, m_credit[index] - bytes);
+    m_urgentClasses.Clear(index);
+    InvalidateSelection();
+    ArmGuaranteeTimer(index);
+}
+
+/**
+ * @brief An urgent class is owed one packet only; otherwise the class may drain its backlog.
+ *
+ * @param index Index of the selected class.
+ * @return The byte allowance of the class.
+ */
+uint32_t
+StrictPriorityQueue::GetBurstBytes(uint32_t index) const
+{
+    return m_urgentClasses.Test(index) ? m_headSizes[index] : DiffServ::GetBurstBytes(index);
+}
+
+/**
+ * @brief A class's guarantee is measured afresh whenever it becomes backlogged, so a packet
+ *        sent while the scheduler was empty leaves nothing to account for.
+ *
+ * @param index Index of the class the packet was classified into.
+ * @return true.
+ */
+bool
+StrictPriorityQueue::CanBypass(uint32_t index) const
+{
+    return true;
+}
+
+/**
+ * @brief Accrue guaranteed service at minRate since the last update.
+ *
+ * @param index Index of the class.
+ */
+void
+StrictPriorityQueue::RefreshCredit(uint32_t index)
+{
+    Time now = Simulator::Now();
+    DataRate minRate = GetTrafficClasses()[index]->GetMinRate();
+    m_credit[index] += (now - m_creditUpdated[index]).GetSeconds() * minRate.GetBitRate() / 8;
+    m_creditUpdated[index] = now;
+}
+
+/**
+ * @brief Schedule the single timer of a class at the earlier of its two bounds.
+ *
+ * With maxWait the bound is the head packet's arrival plus maxWait; with minRate it is the time
+ * the accrued credit covers the head packet. Nothing is scanned periodically: each class has at
+ * most one pending event, re-armed only when its head packet changes.
+ *
+ * @param index Index of the class.
+ */
+void
+StrictPriorityQueue::ArmGuaranteeTimer(uint32_t index)
+{
+    m_guaranteeTimers[index].Cancel();
+    if (m_backlogs[index] == 0)
+    {
+        return;
+    }
+
+    Ptr<TrafficClass> tc = GetTrafficClasses()[index];
+    Time now = Simulator::Now();
+    Time due = Time::Max();
+
+    if (tc->GetMaxWait().IsStrictlyPositive())
+    {
+        due = tc->GetHeadEnqueueTime() + tc->GetMaxWait();
+    }
+    if (tc->GetMinRate().GetBitRate() > 0)
+    {
+        double missingBits = (m_headSizes[index] - m_credit[index]) * 8;
+        Time refill = Seconds(std::max(0.0, missingBits) / tc->GetMinRate().GetBitRate());
+        due = std::min(due, m_creditUpdated[index] + refill);
+    }
+
+    if (due == Time::Max())
+    {
+        return;
+    }
+    if (due <= now)
+    {
+        MarkUrgent(index);
+        return;
+    }
+    m_guaranteeTimers[index] =
+        Simulator::Schedule(due - now, &StrictPriorityQueue::MarkUrgent, this, index);
+}
+
+/**
+ * @brief Let a class jump ahead of higher priorities until its next packet is sent.
+ *
+ * @param index Index of the class.
+ */
+void
+StrictPriorityQueue::MarkUrgent(uint32_t index)
+{
+    if (m_backlogs[index] > 0)
+    {
+        m_urgentClasses.Set(index);
+        InvalidateSelection();
+    }
+}
+
+/**
+ * @brief Cancel the pending guarantee timers.
+ */
+void
+StrictPriorityQueue::DoDispose()
+{
+    for (EventId& timer : m_guaranteeTimers)
+    {
+        timer.Cancel();
+    }
+    DiffServ::DoDispose();
+}
+
 } // namespace ns3
@@ -32,10 +32,31 @@ class StrictPriorityQueue : public DiffServ
   private:
     std::string m_configFile;
 
+    PriorityBitmap m_urgentClasses;         // classes whose minRate or maxWait bound is due
+    std::vector<EventId> m_guaranteeTimers; // per-class timer marking the class urgent
+    std::vector<double> m_credit;           // bytes of guaranteed service owed to each class
+    std::vector<Time> m_creditUpdated;      // time each credit was last brought up to date
+
     int32_t GetQueueForSchedule() const override;
 
+    void ArmGuaranteeTimer(uint32_t index);
+
+    void MarkUrgent(uint32_t index);
+
+    void RefreshCredit(uint32_t index);
+
   protected:
     void DoInitialize() override;
+
+    void DoDispose() override;
+
+    void NotifyEnqueue(uint32_t index) override;
+
+    uint32_t GetBurstBytes(uint32_t index) const override;
+
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    bool CanBypass(uint32_t index) const override;
 };
 
 } // namespace ns3
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "stfq-queue.h"
+
+#include "qos-initializer.h"
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("StfqQueue");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(StfqQueue);
+
+// TypeId registration with ns-3
+TypeId
+StfqQueue::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::StfqQueue<Packet>")
+                            .SetParent<DiffServ>()
+                            .SetGroupName("Network")
+                            .AddConstructor<StfqQueue>()
+                            .AddAttribute("Config",
+                                          "Path to STFQ configuration file",
+                                          StringValue(""),
+                                          MakeStringAccessor(&StfqQueue::m_configFile),
+                                          MakeStringChecker());
+    return tid;
+}
+
+StfqQueue::StfqQueue()
+    : m_virtualTime(0),
+      m_maxFinish(0)
+{
+}
+
+/**
+ * @brief Initializes the STFQ queue using a JSON config file in the DRR format.
+ */
+void
+StfqQueue::DoInitialize()
+{
+    DiffServ::DoInitialize();
+    QosInitializer::InitializeStfqFromJson(this, m_configFile);
+}
+
+/**
+ * @brief Classify incoming packets based on filters in TrafficClass.
+ */
+int32_t
+StfqQueue::Classify(Ptr<Packet> p)
+{
+    return ClassifyByFilters(p);
+}
+
+/**
+ * @brief Add a traffic class. Tags restart from zero for the new set of classes.
+ */
+void
+StfqQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
+{
+    DiffServ::AddTrafficClass(trafficClass);
+
+    uint32_t n = m_weights.size();
+    m_virtualTime = 0;
+    m_maxFinish = 0;
+    m_start.assign(n, 0);
+    m_finish.assign(n, 0);
+    m_startTags.Reset(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (m_backlogs[i] > 0)
+            NotifyEnqueue(i);
+    }
+}
+
+/**
+ * @brief Schedules the next packet for transmission using STFQ.
+ * @return A pointer to the packet to be dequeued, or nullptr if all queues are empty.
+ */
+Ptr<Packet>
+StfqQueue::Schedule()
+{
+    return ServeSelection();
+}
+
+/**
+ * @brief The top of the heap, unless it is out of tokens; then the heap is scanned for the
+ *        smallest start tag among the classes that may send.
+ */
+int32_t
+StfqQueue::GetQueueForSchedule() const
+{
+    int32_t top = m_startTags.Top();
+    if (top < 0 || IsEligible(top))
+    {
+        return top;
+    }
+
+    int32_t selected = -1;
+    for (uint32_t position = 0; position < m_startTags.GetSize(); ++position)
+    {
+        uint32_t i = m_startTags.GetAt(position);
+        if (IsEligible(i) && (selected < 0 || m_start[i] < m_start[selected]))
+            selected = i;
+    }
+    return selected;
+}
+
+/**
+ * @brief A class that becomes backlogged starts at the later of the virtual time and the finish
+ *        tag of its previous packet.
+ */
+void
+StfqQueue::NotifyEnqueue(uint32_t index)
+{
+    if (m_startTags.Contains(index))
+    {
+        return;
+    }
+
+    m_start[index] = std::max(m_virtualTime, m_finish[index]);
+    m_startTags.Push(index, m_start[index]);
+}
+
+/**
+ * @brief At the end of a busy period the virtual time jumps to the largest finish tag, so that
+ *        classes returning later do not inherit credit from the idle time.
+ */
+void
+StfqQueue::NotifyDrained(uint32_t index)
+{
+    m_startTags.Remove(index);
+    if (m_startTags.GetSize() == 0)
+    {
+        m_virtualTime = m_maxFinish;
+    }
+}
+
+/**
+ * @brief Only the head packet carries the current start tag.
+ */
+uint32_t
+StfqQueue::GetBurstBytes(uint32_t index) const
+{
+    return m_headSizes[index];
+}
+
+/**
+ * @brief The packet just sent finishes bytes / weight after it started; a still backlogged
+ *        class tags its next head packet with that finish time.
+ */
+void
+StfqQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    m_finish[index] = m_start[index] + double(bytes) / m_weights[index];
+    m_maxFinish = std::max(m_maxFinish, m_finish[index]);
+
+    if (m_startTags.GetSize() > 0 || m_backlogs[index] > 0)
+    {
+        m_virtualTime = m_start[index];
+    }
+    else
+    {
+        m_virtualTime = m_maxFinish; // the queue just went idle
+    }
+
+    if (m_backlogs[index] > 0)
+    {
+        m_start[index] = m_finish[index];
+        m_startTags.Push(index, m_start[index]);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef STFQ_QUEUE_H
+#define STFQ_QUEUE_H
+
+#include "diff-serv.h"
+#include "indexed-heap.h"
+
+namespace ns3
+{
+
+/**
+ * @brief A DiffServ-based class implementing Start-time Fair Queueing (STFQ).
+ *
+ * Each packet is tagged with a virtual start time, the later of the system virtual time and the
+ * finish tag of the previous packet of its class, and packets are served in start tag order.
+ * The virtual time is self-clocked: it is the start tag of the packet in service, so no fluid
+ * system is emulated. A single heap holds the start tag of every backlogged class's head
+ * packet, so each packet costs O(log n).
+ */
+class StfqQueue : public DiffServ
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Default constructor for StfqQueue.
+     */
+    StfqQueue();
+
+    /**
+     * @brief Schedule the next packet to dequeue using STFQ.
+     *
+     * @return The next scheduled packet, or nullptr if no packets are available.
+     */
+    Ptr<Packet> Schedule() override;
+
+    /**
+     * @brief Classify a packet into one of the traffic classes.
+     *
+     * @param p The packet to classify.
+     * @return Index of the matching traffic class, or -1 if none match.
+     */
+    int32_t Classify(Ptr<Packet> p) override;
+
+    /**
+     * @brief Add a traffic class and reset the tags.
+     *
+     * @param trafficClass Pointer to the TrafficClass to add.
+     */
+    void AddTrafficClass(Ptr<TrafficClass> trafficClass) override;
+
+  protected:
+    /**
+     * @brief Initialize the STFQ queue from its JSON configuration.
+     */
+    void DoInitialize() override;
+
+    /**
+     * @brief Tag the head packet of a class that just became backlogged.
+     *
+     * @param index Index of the class that received a packet.
+     */
+    void NotifyEnqueue(uint32_t index) override;
+
+    /**
+     * @brief Take an emptied class out of the heap, and move the virtual time to the largest
+     *        finish tag once every class is empty.
+     *
+     * @param index Index of the class that became empty.
+     */
+    void NotifyDrained(uint32_t index) override;
+
+    /**
+     * @brief A decision covers a single packet, so that every packet gets its own tag.
+     *
+     * @param index Index of the selected class.
+     * @return The head packet size of the class.
+     */
+    uint32_t GetBurstBytes(uint32_t index) const override;
+
+    /**
+     * @brief Set the virtual time to the start tag of the packet sent and tag the next head.
+     *
+     * @param index Index of the class that was served.
+     * @param bytes Bytes sent.
+     */
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    /**
+     * @brief Get the backlogged class whose head packet has the smallest start tag.
+     *
+     * @return Index of the selected class, or -1 if all queues are empty or shaped.
+     */
+    int32_t GetQueueForSchedule() const override;
+
+  private:
+    std::string m_configFile; // <- come from SetAttribute
+
+    double m_virtualTime;         //!< Start tag of the packet most recently sent
+    double m_maxFinish;           //!< Largest finish tag given so far
+    std::vector<double> m_start;  //!< Start tag of the head packet of each class
+    std::vector<double> m_finish; //!< Finish tag of the last packet sent by each class
+    IndexedHeap m_startTags;      //!< Backlogged classes keyed by their head start tag
+};
+
+} // namespace ns3
+
+#endif // STFQ_QUEUE_H
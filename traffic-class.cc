@@ -8,10 +8,23 @@
 
 #include "traffic-class.h"
 
+#include "diff-serv.h"
+#include "packet-parser.h"
+
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <cmath>
+#include <limits>
+
 namespace ns3
 {
 NS_OBJECT_ENSURE_REGISTERED(TrafficClass);
 
+static bool MarkCongestionExperienced(Ptr<Packet> p);
+static Time GetRefillDelay(double missingBytes, DataRate rate);
+
 TypeId
 TrafficClass::GetTypeId()
 {
@@ -43,19 +56,215 @@ TrafficClass::GetTypeId()
 
             // Register weight
             .AddAttribute("weight",
-                          "quantum of the traffic clas",
+                          "quantum of the traffic clas, at least one byte",
                           UintegerValue(1000),
                           MakeUintegerAccessor(&TrafficClass::weight),
-                          MakeUintegerChecker<uint32_t>());
+                          MakeUintegerChecker<uint32_t>(1))
+
+            // Register useEcn
+            .AddAttribute("useEcn",
+                          "Mark ECN-capable packets CE instead of dropping them on congestion",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TrafficClass::useEcn),
+                          MakeBooleanChecker())
+
+            // Register congestionThreshold
+            .AddAttribute("congestionThreshold",
+                          "Backlog in packets at which arrivals signal congestion (0 disables)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TrafficClass::congestionThreshold),
+                          MakeUintegerChecker<uint32_t>())
+
+            // Register rate
+            .AddAttribute("rate",
+                          "Token bucket rate capping the class (0 leaves the class unshaped)",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&TrafficClass::rate),
+                          MakeDataRateChecker())
+
+            // Register burst
+            .AddAttribute("burst",
+                          "Token bucket depth in bytes",
+                          UintegerValue(3000),
+                          MakeUintegerAccessor(&TrafficClass::burst),
+                          MakeUintegerChecker<uint32_t>(1))
+
+            // Register ceil
+            .AddAttribute("ceil",
+                          "Rate the class may reach by borrowing unused bandwidth (0 = rate)",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&TrafficClass::ceil),
+                          MakeDataRateChecker())
+
+            // Register flowQueues
+            .AddAttribute("flowQueues",
+                          "Number of per-flow sub-queues served fairly (0 keeps a single FIFO)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TrafficClass::flowQueues),
+                          MakeUintegerChecker<uint32_t>())
+
+            // Register flowQuantum
+            .AddAttribute("flowQuantum",
+                          "Bytes each flow sub-queue may send per round",
+                          UintegerValue(1514),
+                          MakeUintegerAccessor(&TrafficClass::flowQuantum),
+                          MakeUintegerChecker<uint32_t>(1))
+
+            // Register useCodel
+            .AddAttribute("useCodel",
+                          "Whether CoDel runs on every flow sub-queue",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TrafficClass::useCodel),
+                          MakeBooleanChecker())
+
+            // Register codelTarget
+            .AddAttribute("codelTarget",
+                          "CoDel target sojourn time",
+                          TimeValue(MilliSeconds(5)),
+                          MakeTimeAccessor(&TrafficClass::codelTarget),
+                          MakeTimeChecker())
+
+            // Register codelInterval
+            .AddAttribute("codelInterval",
+                          "CoDel interval",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&TrafficClass::codelInterval),
+                          MakeTimeChecker())
+
+            // Register minRate
+            .AddAttribute("minRate",
+                          "Rate guaranteed to the class even under strict priority (0 = none)",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&TrafficClass::minRate),
+                          MakeDataRateChecker())
+
+            // Register maxWait
+            .AddAttribute("maxWait",
+                          "Head-of-line waiting time after which the class is served (0 = none)",
+                          TimeValue(Time(0)),
+                          MakeTimeAccessor(&TrafficClass::maxWait),
+                          MakeTimeChecker())
+
+            // Register lowLatency
+            .AddAttribute("lowLatency",
+                          "Whether LLQ serves this class with strict priority",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TrafficClass::lowLatency),
+                          MakeBooleanChecker())
+
+            // Register policeRate
+            .AddAttribute("policeRate",
+                          "Policer rate; arrivals exceeding it are dropped (0 disables)",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&TrafficClass::policeRate),
+                          MakeDataRateChecker())
+
+            // Register policeBurst
+            .AddAttribute("policeBurst",
+                          "Policer bucket depth in bytes",
+                          UintegerValue(3000),
+                          MakeUintegerAccessor(&TrafficClass::policeBurst),
+                          MakeUintegerChecker<uint32_t>(1))
+
+            // Register delayBudget
+            .AddAttribute("delayBudget",
+                          "Queueing delay a packet of this class may see before its deadline",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&TrafficClass::delayBudget),
+                          MakeTimeChecker())
+
+            // Register realTimeM1
+            .AddAttribute("realTimeM1",
+                          "HFSC real-time curve: rate guaranteed over the first realTimeD",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&TrafficClass::realTimeM1),
+                          MakeDataRateChecker())
+
+            // Register realTimeD
+            .AddAttribute("realTimeD",
+                          "HFSC real-time curve: length of the first segment",
+                          TimeValue(Time(0)),
+                          MakeTimeAccessor(&TrafficClass::realTimeD),
+                          MakeTimeChecker())
+
+            // Register realTimeM2
+            .AddAttribute("realTimeM2",
+                          "HFSC real-time curve: long-term rate (0 with realTimeM1 0 = none)",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&TrafficClass::realTimeM2),
+                          MakeDataRateChecker())
+
+            // Register linkShareM1
+            .AddAttribute("linkShareM1",
+                          "HFSC link-sharing curve: rate over the first linkShareD",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&TrafficClass::linkShareM1),
+                          MakeDataRateChecker())
+
+            // Register linkShareD
+            .AddAttribute("linkShareD",
+                          "HFSC link-sharing curve: length of the first segment",
+                          TimeValue(Time(0)),
+                          MakeTimeAccessor(&TrafficClass::linkShareD),
+                          MakeTimeChecker())
+
+            // Register linkShareM2
+            .AddAttribute("linkShareM2",
+                          "HFSC link-sharing curve: long-term rate (0 with linkShareM1 0 = weight)",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&TrafficClass::linkShareM2),
+                          MakeDataRateChecker());
 
     return tid;
 }
 
 TrafficClass::TrafficClass()
-    : packets(0)
+    : packets(0),
+      droppedPackets(0),
+      markedPackets(0),
+      tokens(std::numeric_limits<double>::infinity()), // the bucket starts full
+      ceilTokens(std::numeric_limits<double>::infinity()),
+      lastRefill(0),
+      policeTokens(std::numeric_limits<double>::infinity()),
+      policeRefill(0)
+{
+}
+
+TrafficClass::~TrafficClass()
 {
 }
 
+/**
+ * @brief Sets up the flow sub-queues once the attributes are known
+ */
+void
+TrafficClass::NotifyConstructionCompleted()
+{
+    Object::NotifyConstructionCompleted();
+    NS_ABORT_MSG_IF(ceil.GetBitRate() > 0 && ceil.GetBitRate() < rate.GetBitRate(),
+                    "ceil must not be below rate");
+    if (flowQueues > 0)
+    {
+        m_flows.Configure(flowQueues, flowQuantum, useCodel, codelTarget, codelInterval);
+        m_flows.SetCongestionCallback(MakeCallback(&TrafficClass::SignalQueuedCongestion, this));
+    }
+}
+
+/**
+ * @brief Releases the child scheduler, if any
+ */
+void
+TrafficClass::DoDispose()
+{
+    m_dropCallback.Nullify();
+    if (m_child)
+    {
+        m_child->Dispose();
+        m_child = nullptr;
+    }
+    Object::DoDispose();
+}
+
 /**
  * @brief Returns true if this traffic class is the default fallback class
  */
@@ -68,16 +277,80 @@ TrafficClass::IsDefault() const
 /**
  * @brief Attempts to enqueue a packet into the traffic class
  *
+ * Arrivals exceeding the policer are dropped. Once the backlog reaches congestionThreshold,
+ * arrivals are CE-marked when ECN is enabled and the packet is ECN-capable, and dropped
+ * otherwise. A full queue drops the arrival, except in flow queue mode: there the tail packet
+ * of the fattest flow is dropped and reported through the drop callback, so that one
+ * aggressive flow cannot lock the others out.
+ *
  * @param p Packet to enqueue
- * @return true if successful, false if the queue is full
+ * @return true if successful, false if the packet was dropped
  */
 bool
 TrafficClass::Enqueue(Ptr<ns3::Packet> p)
 {
-    if (packets == maxPackets)
+    return Enqueue(p, Simulator::Now());
+}
+
+/**
+ * @brief Attempts to enqueue a packet that arrived at the given time
+ *
+ * Used for a packet the scheduler held back before queueing it here, so that its sojourn time
+ * and head-of-line wait count from its arrival.
+ *
+ * @param p Packet to enqueue
+ * @param enqueueTime Arrival time of the packet, not later than now
+ * @return true if successful, false if the packet was dropped
+ */
+bool
+TrafficClass::Enqueue(Ptr<ns3::Packet> p, Time enqueueTime)
+{
+    bool full = IsFull();
+    if (full && !m_flows.IsEnabled())
+    {
+        droppedPackets++;
+        return false;
+    }
+
+    if (IsPoliced() && !Police(p))
+    {
+        droppedPackets++;
+        return false;
+    }
+
+    if (congestionThreshold > 0 && packets >= congestionThreshold && !SignalCongestion(p))
         return false;
 
-    m_queue.push(p);
+    if (m_child)
+    {
+        // The child classifies the packet again and counts its own drops
+        if (!m_child->Enqueue(p))
+        {
+            droppedPackets++;
+            return false;
+        }
+        packets = m_child->GetBackloggedPackets();
+        return true;
+    }
+
+    if (full)
+    {
+        // Room is only made once the arrival is known to be admitted
+        QueuedPacket victim;
+        if (!m_flows.DropTail(victim))
+        {
+            droppedPackets++;
+            return false;
+        }
+        packets--;
+        droppedPackets++;
+        NotifyQueuedDrop(victim.packet);
+    }
+
+    if (m_flows.IsEnabled())
+        m_flows.Enqueue({p, enqueueTime});
+    else
+        m_queue.push_back({p, enqueueTime});
     packets++;
 
     return true;
@@ -86,7 +359,11 @@ TrafficClass::Enqueue(Ptr<ns3::Packet> p)
 /**
  * @brief Dequeues and returns the next packet in the queue
  *
- * @return Ptr to the dequeued packet, or nullptr if queue is empty
+ * In flow queue mode CoDel may drop head packets of the served flow first, so the class can
+ * lose more than one packet per call. A class backed by a child scheduler returns whatever the
+ * child schedules; the sojourn times are then recorded by the classes of the child.
+ *
+ * @return Ptr to the dequeued packet, or nullptr if queue is empty or the child cannot send
  */
 Ptr<Packet>
 TrafficClass::Dequeue()
@@ -94,13 +371,142 @@ TrafficClass::Dequeue()
     if (packets == 0)
         return nullptr;
 
-    Ptr<Packet> p = m_queue.front();
+    Ptr<Packet> p;
+    Time now = Simulator::Now();
+    if (m_child)
+    {
+        p = m_child->Dequeue();
+        packets = m_child->GetBackloggedPackets();
+        if (!p)
+            return nullptr;
+    }
+    else
+    {
+        QueuedPacket item;
+        if (m_flows.IsEnabled())
+        {
+            m_flows.Dequeue(item);
+            packets = m_flows.GetPackets();
+        }
+        else
+        {
+            item = m_queue.front();
+            m_queue.pop_front();
+            packets--;
+        }
+        p = item.packet;
+        sojournTimes.Record(now - item.enqueueTime);
+    }
+
+    if (IsShaped())
+    {
+        // Both buckets are charged, so that borrowing beyond rate leaves the class in debt
+        tokens = GetTokensAt(now) - p->GetSize();
+        ceilTokens = GetCeilTokensAt(now) - p->GetSize();
+        lastRefill = now;
+    }
+    return p;
+}
 
-    m_queue.pop();
+/**
+ * @brief Dequeues consecutive head packets in one call
+ *
+ * Stops at maxPackets, before the next head packet would exceed maxBytes, or once a shaped
+ * class runs out of tokens.
+ *
+ * @param maxPackets Largest number of packets to return
+ * @param maxBytes Largest total size of the returned packets
+ * @return The dequeued packets in order, possibly none
+ */
+std::vector<Ptr<Packet>>
+TrafficClass::DequeueBurst(uint32_t maxPackets, uint32_t maxBytes)
+{
+    std::vector<Ptr<Packet>> burst;
+    uint32_t bytes = 0;
+    while (burst.size() < maxPackets && packets > 0 && IsConforming())
+    {
+        uint32_t size = Peek()->GetSize();
+        if (size > maxBytes - bytes)
+            break;
+
+        // A child scheduler may have dropped all it held instead
+        Ptr<Packet> p = Dequeue();
+        if (!p)
+            break;
+        bytes += p->GetSize();
+        burst.push_back(p);
+    }
+    return burst;
+}
+
+/**
+ * @brief Drops the most recently enqueued packet to make room for another arrival
+ *
+ * In flow queue mode the packet is taken from the flow holding the most bytes, and with a child
+ * scheduler from the tail of the child's longest class.
+ *
+ * @return Ptr to the dropped packet, or nullptr if queue is empty
+ */
+Ptr<Packet>
+TrafficClass::DropTail()
+{
+    if (packets == 0)
+        return nullptr;
+
+    if (m_child)
+    {
+        Ptr<Packet> p = m_child->DropTail();
+        packets = m_child->GetBackloggedPackets();
+        if (p)
+            droppedPackets++;
+        return p;
+    }
+
+    QueuedPacket item;
+    if (m_flows.IsEnabled())
+    {
+        m_flows.DropTail(item);
+    }
+    else
+    {
+        item = m_queue.back();
+        m_queue.pop_back();
+    }
+
+    Ptr<Packet> p = item.packet;
     packets--;
+    droppedPackets++;
     return p;
 }
 
+/**
+ * @brief Counts a drop decided outside of this class, e.g. by a shared buffer limit
+ */
+void
+TrafficClass::RecordDrop()
+{
+    droppedPackets++;
+}
+
+/**
+ * @brief Returns true if the queue holds maxPackets packets
+ */
+bool
+TrafficClass::IsFull() const
+{
+    return packets >= maxPackets;
+}
+
+/**
+ * @brief Returns true if the class hashes flows into sub-queues, and so makes room for an
+ *        arrival itself when full
+ */
+bool
+TrafficClass::IsFlowQueued() const
+{
+    return m_flows.IsEnabled();
+}
+
 /**
  * @brief Check if the packet matches any of the configured filters
  *
@@ -109,10 +515,25 @@ TrafficClass::Dequeue()
  */
 bool
 TrafficClass::Match(Ptr<Packet> p) const
+{
+    Ipv4Header header;
+    Ptr<Packet> payload;
+    return PacketParser::ParseIpv4(p, header, payload) && Match(header, payload);
+}
+
+/**
+ * @brief Check if a packet whose headers are already parsed matches any of the filters
+ *
+ * @param header IPv4 header of the packet
+ * @param payload Packet behind the IPv4 header
+ * @return true if any filter matches, false otherwise
+ */
+bool
+TrafficClass::Match(const Ipv4Header& header, Ptr<const Packet> payload) const
 {
     for (Ptr<Filter> filter : filters)
     {
-        if (filter->Match(p))
+        if (filter->Match(header, payload))
             return true;
     }
     return false;
@@ -130,7 +551,9 @@ TrafficClass::GetPackets() const
 /**
  * @brief Returns the front packet in the queue without removing it
  *
- * @return Ptr to the packet, or nullptr if queue is empty
+ * With a child scheduler this is the packet the child would send next.
+ *
+ * @return Ptr to the packet, or nullptr if queue is empty or the child cannot send
  */
 Ptr<Packet>
 TrafficClass::Peek() const
@@ -138,7 +561,28 @@ TrafficClass::Peek() const
     if (packets == 0)
         return nullptr;
 
-    return m_queue.front();
+    if (m_child)
+        return ConstCast<Packet>(m_child->Peek());
+
+    return m_flows.IsEnabled() ? m_flows.Peek() : m_queue.front().packet;
+}
+
+/**
+ * @brief Returns the arrival time of the front packet, or zero if the queue is empty
+ *
+ * A child scheduler does not expose arrival times, so a class backed by one reports the
+ * current time, i.e. no head-of-line wait.
+ */
+Time
+TrafficClass::GetHeadEnqueueTime() const
+{
+    if (packets == 0)
+        return Time(0);
+
+    if (m_child)
+        return Simulator::Now();
+
+    return m_flows.IsEnabled() ? m_flows.GetHeadEnqueueTime() : m_queue.front().enqueueTime;
 }
 
 /**
@@ -170,4 +614,391 @@ TrafficClass::AddFilter(Ptr<Filter> filter)
     filters.push_back(filter);
 }
 
+/**
+ * @brief Returns the number of packets dropped by this traffic class
+ */
+uint64_t
+TrafficClass::GetDroppedPackets() const
+{
+    return droppedPackets;
+}
+
+/**
+ * @brief Returns the number of packets CE-marked instead of dropped
+ */
+uint64_t
+TrafficClass::GetMarkedPackets() const
+{
+    return markedPackets;
+}
+
+/**
+ * @brief Returns the sojourn time histogram of packets dequeued from this class
+ */
+const SojournHistogram&
+TrafficClass::GetSojournHistogram() const
+{
+    return sojournTimes;
+}
+
+/**
+ * @brief Clears the sojourn time histogram, e.g. to start a new reporting period
+ */
+void
+TrafficClass::ResetSojournHistogram()
+{
+    sojournTimes.Reset();
+}
+
+/**
+ * @brief Records the queueing delay of a packet that left without passing through this queue
+ *
+ * @param sojourn Time between the packet's arrival and its departure
+ */
+void
+TrafficClass::RecordSojourn(Time sojourn)
+{
+    sojournTimes.Record(sojourn);
+}
+
+/**
+ * @brief Returns the queueing delay budget used to compute packet deadlines
+ */
+Time
+TrafficClass::GetDelayBudget() const
+{
+    return delayBudget;
+}
+
+/**
+ * @brief Returns the HFSC real-time service curve, the zero curve if none is configured
+ */
+ServiceCurve
+TrafficClass::GetRealTimeCurve() const
+{
+    return ServiceCurve(realTimeM1, realTimeD, realTimeM2);
+}
+
+/**
+ * @brief Returns the HFSC link-sharing service curve, the zero curve if none is configured
+ */
+ServiceCurve
+TrafficClass::GetLinkShareCurve() const
+{
+    return ServiceCurve(linkShareM1, linkShareD, linkShareM2);
+}
+
+/**
+ * @brief Queues the packets of this class in a child scheduler instead of a FIFO
+ *
+ * The child classifies arrivals with its own filters and decides which of its packets this
+ * class sends next, while the limits, policer and token buckets of this class still apply to
+ * the aggregate. Flow queue mode is not used together with a child.
+ *
+ * @param child The scheduler, which must not hold packets yet
+ */
+void
+TrafficClass::SetChild(Ptr<DiffServ> child)
+{
+    NS_ABORT_MSG_IF(packets > 0, "A child scheduler cannot be added to a backlogged class");
+    m_child = child;
+    m_child->TraceConnectWithoutContext("DropAfterDequeue",
+                                        MakeCallback(&TrafficClass::NotifyQueuedDrop, this));
+}
+
+/**
+ * @brief Returns the child scheduler of this class, or nullptr if it queues packets itself
+ */
+Ptr<DiffServ>
+TrafficClass::GetChild() const
+{
+    return m_child;
+}
+
+/**
+ * @brief Registers the callback told of queued packets this class drops on its own
+ *
+ * Such drops happen inside Dequeue, when CoDel drops head packets, and inside a child
+ * scheduler. Drops the caller asks for (DropTail) or sees as a failed Enqueue are not reported.
+ *
+ * @param cb Callback receiving the dropped packet, normally set by the owning DiffServ
+ */
+void
+TrafficClass::SetDropCallback(Callback<void, Ptr<const Packet>> cb)
+{
+    m_dropCallback = cb;
+}
+
+/**
+ * @brief Returns true if LLQ should serve this class with strict priority
+ */
+bool
+TrafficClass::IsLowLatency() const
+{
+    return lowLatency;
+}
+
+/**
+ * @brief Returns the service rate guaranteed to this class, zero if none
+ */
+DataRate
+TrafficClass::GetMinRate() const
+{
+    return minRate;
+}
+
+/**
+ * @brief Returns the head-of-line waiting bound of this class, zero if none
+ */
+Time
+TrafficClass::GetMaxWait() const
+{
+    return maxWait;
+}
+
+/**
+ * @brief Returns true if a token bucket rate or ceil is configured for this class
+ */
+bool
+TrafficClass::IsShaped() const
+{
+    return rate.GetBitRate() > 0 || ceil.GetBitRate() > 0;
+}
+
+/**
+ * @brief Returns true if arrivals are checked against a policer
+ */
+bool
+TrafficClass::IsPoliced() const
+{
+    return policeRate.GetBitRate() > 0;
+}
+
+/**
+ * @brief Check whether the head packet may be sent now without exceeding the token bucket
+ *
+ * With a ceil, the ceil bucket caps the class and the rate bucket only tells whether it is
+ * borrowing. A head packet larger than the bucket depth is allowed once the bucket is full, and
+ * the excess is carried as token debt. A class backed by a child scheduler also needs the child
+ * to be able to send.
+ *
+ * @return true if the class is unshaped or holds enough tokens for its head packet
+ */
+bool
+TrafficClass::IsConforming() const
+{
+    if (m_child && packets > 0 && !m_child->Peek())
+        return false;
+
+    if (!IsShaped() || packets == 0)
+        return true;
+
+    uint32_t needed = std::min(Peek()->GetSize(), burst);
+    Time now = Simulator::Now();
+    if (ceil.GetBitRate() > 0)
+        return GetCeilTokensAt(now) >= needed;
+    return GetTokensAt(now) >= needed;
+}
+
+/**
+ * @brief Returns the earliest time at which the head packet conforms to the token bucket
+ *
+ * While a child scheduler cannot send, this is the time the child may send again; the bucket is
+ * checked once the child's next packet is known.
+ *
+ * @return The current time if already conforming, otherwise the time the bucket refills enough
+ */
+Time
+TrafficClass::GetNextConformingTime() const
+{
+    Time now = Simulator::Now();
+    if (IsConforming())
+        return now;
+
+    if (m_child && !m_child->Peek())
+        return m_child->GetNextConformingTime();
+
+    uint32_t needed = std::min(Peek()->GetSize(), burst);
+    if (ceil.GetBitRate() > 0)
+        return now + GetRefillDelay(needed - GetCeilTokensAt(now), ceil);
+    return now + GetRefillDelay(needed - GetTokensAt(now), rate);
+}
+
+/**
+ * @brief Check whether the head packet fits the rate bucket, i.e. can be sent without borrowing
+ *
+ * Without a ceil the rate is the cap, so any class within it is conforming as well.
+ *
+ * @return true if the class needs no bandwidth beyond its rate to send its head packet
+ */
+bool
+TrafficClass::IsWithinRate() const
+{
+    if (ceil.GetBitRate() == 0 || packets == 0 || !Peek())
+        return true;
+
+    uint32_t needed = std::min(Peek()->GetSize(), burst);
+    return GetTokensAt(Simulator::Now()) >= needed;
+}
+
+/**
+ * @brief Returns the earliest time at which the head packet fits the rate bucket
+ *
+ * @return The current time if already within rate, Time::Max() if the rate is zero
+ */
+Time
+TrafficClass::GetNextWithinRateTime() const
+{
+    Time now = Simulator::Now();
+    if (IsWithinRate())
+        return now;
+
+    if (rate.GetBitRate() == 0)
+        return Time::Max();
+
+    uint32_t needed = std::min(Peek()->GetSize(), burst);
+    return now + GetRefillDelay(needed - GetTokensAt(now), rate);
+}
+
+/**
+ * @brief Returns the token count the bucket holds at the given time
+ *
+ * @param now Time to evaluate the bucket at, not earlier than the last refill
+ */
+double
+TrafficClass::GetTokensAt(Time now) const
+{
+    double refill = (now - lastRefill).GetSeconds() * rate.GetBitRate() / 8;
+    return std::min<double>(burst, tokens + refill);
+}
+
+/**
+ * @brief Returns the token count the ceil bucket holds at the given time
+ *
+ * @param now Time to evaluate the bucket at, not earlier than the last refill
+ */
+double
+TrafficClass::GetCeilTokensAt(Time now) const
+{
+    double refill = (now - lastRefill).GetSeconds() * ceil.GetBitRate() / 8;
+    return std::min<double>(burst, ceilTokens + refill);
+}
+
+/**
+ * @brief Charges an arrival against the policer bucket
+ *
+ * @param p The arriving packet
+ * @return true if the packet conforms, false if it exceeds the policed rate
+ */
+bool
+TrafficClass::Police(Ptr<ns3::Packet> p)
+{
+    Time now = Simulator::Now();
+    double refill = (now - policeRefill).GetSeconds() * policeRate.GetBitRate() / 8;
+    policeTokens = std::min<double>(policeBurst, policeTokens + refill);
+    policeRefill = now;
+
+    if (p->GetSize() > policeTokens)
+        return false;
+
+    policeTokens -= p->GetSize();
+    return true;
+}
+
+/**
+ * @brief Applies a congestion signal to a packet: a CE mark if possible, a drop otherwise
+ *
+ * @param p Packet the congestion decision was taken on
+ * @return true if the packet was marked and should still be queued, false if it is dropped
+ */
+bool
+TrafficClass::SignalCongestion(Ptr<ns3::Packet> p)
+{
+    if (useEcn && MarkCongestionExperienced(p))
+    {
+        markedPackets++;
+        return true;
+    }
+
+    droppedPackets++;
+    return false;
+}
+
+/**
+ * @brief CoDel verdict on a queued packet: marks it if possible, otherwise reports its drop
+ *
+ * @param p Head packet CoDel wants to drop
+ * @return true if the packet was CE-marked and stays, false if it is dropped
+ */
+bool
+TrafficClass::SignalQueuedCongestion(Ptr<ns3::Packet> p)
+{
+    if (SignalCongestion(p))
+        return true;
+
+    NotifyQueuedDrop(p);
+    return false;
+}
+
+/**
+ * @brief Passes a queued packet dropped by this class or its child on to the drop callback
+ *
+ * @param p The dropped packet
+ */
+void
+TrafficClass::NotifyQueuedDrop(Ptr<const ns3::Packet> p)
+{
+    if (!m_dropCallback.IsNull())
+        m_dropCallback(p);
+}
+
+/**
+ * @brief Returns how long a bucket filling at the given rate takes to gain the missing bytes
+ *
+ * @param missingBytes Bytes the bucket lacks, positive
+ * @param rate Refill rate of the bucket, non-zero
+ * @return The delay, rounded up to the next nanosecond so that the bucket has really refilled
+ */
+static Time
+GetRefillDelay(double missingBytes, DataRate rate)
+{
+    double waitNs = std::ceil(missingBytes * 8 * 1e9 / rate.GetBitRate());
+    return NanoSeconds(std::max<uint64_t>(1, static_cast<uint64_t>(waitNs)));
+}
+
+/**
+ * @brief Rewrites the IPv4 ECN field of a packet to CE
+ *
+ * @param p Packet starting with an IPv4 header, possibly behind a PPP header
+ * @return true if the packet is ECN-capable and now carries CE, false otherwise
+ */
+static bool
+MarkCongestionExperienced(Ptr<Packet> p)
+{
+    PppHeader pppHeader;
+    bool framed = PacketParser::RemovePppHeader(p, pppHeader);
+    Ipv4Header ipHeader;
+    if (p->RemoveHeader(ipHeader) == 0)
+    {
+        if (framed)
+            p->AddHeader(pppHeader);
+        return false;
+    }
+
+    bool capable = ipHeader.GetEcn() != Ipv4Header::ECN_NotECT;
+    if (capable)
+    {
+        ipHeader.SetEcn(Ipv4Header::ECN_CE);
+    }
+    if (Node::ChecksumEnabled())
+    {
+        ipHeader.EnableChecksum();
+    }
+
+    p->AddHeader(ipHeader);
+    if (framed)
+        p->AddHeader(pppHeader);
+    return capable;
+}
+
 } // namespace ns3
@@ -10,12 +10,22 @@
 #define TRAFFIC_CLASS_H
 
 #include "filter-class.h"
+#include "flow-queue-set.h"
+#include "service-curve.h"
+#include "sojourn-histogram.h"
 
+#include "ns3/callback.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
 #include "ns3/object.h"
 
+#include <deque>
+
 namespace ns3
 {
 
+class DiffServ;
+
 class TrafficClass : public Object
 {
   private:
@@ -24,31 +34,141 @@ class TrafficClass : public Object
     double_t weight; // applicable if the QoS mechanism uses weights
     uint32_t priority_level;
     bool isDefault;                       // whether this queue is served as the default queue
-    std::queue<Ptr<ns3::Packet>> m_queue; // the queue that holds packet waiting to be scheduled
+    bool useEcn;                          // CE-mark ECN-capable packets instead of dropping them
+    uint32_t congestionThreshold;         // backlog at which arrivals signal congestion (0 = off)
+    uint64_t droppedPackets;              // packets dropped by this class
+    uint64_t markedPackets;               // packets CE-marked instead of dropped
+    DataRate rate;                        // token bucket rate, zero leaves the class unshaped
+    uint32_t burst;                       // token bucket depth in bytes
+    double tokens;                        // bytes available at lastRefill, negative when in debt
+    DataRate ceil;                        // rate the class may borrow up to, 0 caps it at rate
+    double ceilTokens;                    // ceil bucket bytes available at lastRefill
+    Time lastRefill;                      // time the token count was last brought up to date
+    uint32_t flowQueues;                  // number of per-flow sub-queues, 0 keeps a single FIFO
+    uint32_t flowQuantum;                 // bytes each flow may send per round
+    bool useCodel;                        // whether CoDel runs on every flow sub-queue
+    Time codelTarget;                     // CoDel target sojourn time
+    Time codelInterval;                   // CoDel interval
+    FlowQueueSet m_flows;                 // the per-flow sub-queues used instead of m_queue
+    DataRate minRate;                     // service rate guaranteed despite strict priority
+    Time maxWait;                         // head-of-line wait after which the class is served
+    bool lowLatency;                      // served ahead of weighted classes by LLQ
+    DataRate policeRate;                  // policer rate, arrivals beyond it are dropped (0 = off)
+    uint32_t policeBurst;                 // policer bucket depth in bytes
+    double policeTokens;                  // policer bytes available at policeRefill
+    Time policeRefill;                    // time the policer was last brought up to date
+    Time delayBudget;                     // queueing delay a packet may see, deadline schedulers
+    DataRate realTimeM1;                  // HFSC real-time curve: rate over the first realTimeD
+    Time realTimeD;                       // HFSC real-time curve: length of the first segment
+    DataRate realTimeM2;                  // HFSC real-time curve: long-term rate (0 = none)
+    DataRate linkShareM1;                 // HFSC link-sharing curve: rate over the first segment
+    Time linkShareD;                      // HFSC link-sharing curve: length of the first segment
+    DataRate linkShareM2;                 // HFSC link-sharing curve: long-term rate (0 = weight)
+    std::deque<QueuedPacket> m_queue;     // the queue that holds packet waiting to be scheduled
+    Ptr<DiffServ> m_child;                // scheduler holding the packets instead of m_queue
     std::vector<Ptr<Filter>> filters;     // a collection of Filters
+    SojournHistogram sojournTimes;        // queueing delay of every dequeued packet
+
+    Callback<void, Ptr<const Packet>> m_dropCallback; // told of queued packets dropped here
 
   public:
     static TypeId GetTypeId();
 
     TrafficClass();
 
+    ~TrafficClass() override;
+
     bool IsDefault() const;
 
     bool Enqueue(Ptr<ns3::Packet> p);
 
+    bool Enqueue(Ptr<ns3::Packet> p, Time enqueueTime);
+
     Ptr<ns3::Packet> Dequeue();
 
+    std::vector<Ptr<ns3::Packet>> DequeueBurst(uint32_t maxPackets, uint32_t maxBytes);
+
+    Ptr<ns3::Packet> DropTail();
+
+    void RecordDrop();
+
+    bool IsFull() const;
+
+    bool IsFlowQueued() const;
+
     bool Match(Ptr<ns3::Packet> p) const;
 
+    bool Match(const Ipv4Header& header, Ptr<const ns3::Packet> payload) const;
+
     uint32_t GetPackets() const;
 
     Ptr<ns3::Packet> Peek() const;
 
+    Time GetHeadEnqueueTime() const;
+
     uint32_t GetPriorityLevel() const;
 
     uint32_t GetWeight() const;
 
     void AddFilter(Ptr<Filter> filter);
+
+    uint64_t GetDroppedPackets() const;
+
+    uint64_t GetMarkedPackets() const;
+
+    bool IsShaped() const;
+
+    bool IsPoliced() const;
+
+    bool IsConforming() const;
+
+    Time GetNextConformingTime() const;
+
+    bool IsWithinRate() const;
+
+    Time GetNextWithinRateTime() const;
+
+    const SojournHistogram& GetSojournHistogram() const;
+
+    void ResetSojournHistogram();
+
+    void RecordSojourn(Time sojourn);
+
+    bool IsLowLatency() const;
+
+    DataRate GetMinRate() const;
+
+    Time GetMaxWait() const;
+
+    Time GetDelayBudget() const;
+
+    ServiceCurve GetRealTimeCurve() const;
+
+    ServiceCurve GetLinkShareCurve() const;
+
+    void SetChild(Ptr<DiffServ> child);
+
+    Ptr<DiffServ> GetChild() const;
+
+    void SetDropCallback(Callback<void, Ptr<const ns3::Packet>> cb);
+
+  protected:
+    void NotifyConstructionCompleted() override;
+
+    void DoDispose() override;
+
+  private:
+    bool SignalCongestion(Ptr<ns3::Packet> p);
+
+    bool SignalQueuedCongestion(Ptr<ns3::Packet> p);
+
+    void NotifyQueuedDrop(Ptr<const ns3::Packet> p);
+
+    double GetTokensAt(Time now) const;
+
+    double GetCeilTokensAt(Time now) const;
+
+    bool Police(Ptr<ns3::Packet> p);
 };
 
 } // namespace ns3
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "virtual-clock-queue.h"
+
+#include "qos-initializer.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("VirtualClockQueue");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(VirtualClockQueue);
+
+// TypeId registration with ns-3
+TypeId
+VirtualClockQueue::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::VirtualClockQueue<Packet>")
+            .SetParent<DiffServ>()
+            .SetGroupName("Network")
+            .AddConstructor<VirtualClockQueue>()
+            .AddAttribute("Config",
+                          "Path to Virtual Clock configuration file",
+                          StringValue(""),
+                          MakeStringAccessor(&VirtualClockQueue::m_configFile),
+                          MakeStringChecker())
+            .AddAttribute("SlotWidth",
+                          "Stamp range sharing one calendar queue bucket, about a packet time",
+                          TimeValue(MicroSeconds(100)),
+                          MakeTimeAccessor(&VirtualClockQueue::m_slotWidth),
+                          MakeTimeChecker());
+    return tid;
+}
+
+VirtualClockQueue::VirtualClockQueue()
+{
+}
+
+/**
+ * @brief Initializes the Virtual Clock queue using a JSON config file in the DRR format.
+ */
+void
+VirtualClockQueue::DoInitialize()
+{
+    DiffServ::DoInitialize();
+    QosInitializer::InitializeVirtualClockFromJson(this, m_configFile);
+}
+
+/**
+ * @brief Classify incoming packets based on filters in TrafficClass.
+ */
+int32_t
+VirtualClockQueue::Classify(Ptr<Packet> p)
+{
+    return ClassifyByFilters(p);
+}
+
+/**
+ * @brief Add a traffic class. A class reserves its minRate, or else its weight in bytes per
+ *        second; clocks restart from zero for the new set of classes.
+ */
+void
+VirtualClockQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
+{
+    DiffServ::AddTrafficClass(trafficClass);
+
+    const auto& q_class = GetTrafficClasses();
+    uint32_t n = q_class.size();
+    m_rates.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint64_t bitRate = q_class[i]->GetMinRate().GetBitRate();
+        m_rates[i] = bitRate > 0 ? bitRate / 8e9 : m_weights[i] / 1e9;
+        NS_ABORT_MSG_IF(m_rates[i] <= 0, "Virtual Clock class " << i << " reserves no rate");
+    }
+
+    m_clock.assign(n, 0);
+    m_stamps.Reset(n, m_slotWidth.GetNanoSeconds());
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (m_backlogs[i] > 0)
+            NotifyEnqueue(i);
+    }
+}
+
+/**
+ * @brief Schedules the next packet for transmission using Virtual Clock.
+ * @return A pointer to the packet to be dequeued, or nullptr if all queues are empty.
+ */
+Ptr<Packet>
+VirtualClockQueue::Schedule()
+{
+    return ServeSelection();
+}
+
+/**
+ * @brief The top of the calendar queue, unless it is out of tokens; then the backlogged
+ *        classes are scanned for the earliest stamp among those that may send.
+ */
+int32_t
+VirtualClockQueue::GetQueueForSchedule() const
+{
+    int32_t top = m_stamps.Top();
+    if (top < 0 || IsEligible(top))
+    {
+        return top;
+    }
+
+    int32_t selected = -1;
+    for (int32_t i = m_activeClasses.FindFirst(); i >= 0; i = m_activeClasses.FindNext(i))
+    {
+        if (IsEligible(i) && (selected < 0 || m_stamps.GetKey(i) < m_stamps.GetKey(selected)))
+            selected = i;
+    }
+    return selected;
+}
+
+/**
+ * @brief Only a class that was empty needs a stamp; otherwise its head packet is unchanged.
+ */
+void
+VirtualClockQueue::NotifyEnqueue(uint32_t index)
+{
+    if (!m_stamps.Contains(index))
+    {
+        StampHead(index);
+    }
+}
+
+/**
+ * @brief The clock of an emptied class is kept; a later arrival starts from the larger of the
+ *        two.
+ */
+void
+VirtualClockQueue::NotifyDrained(uint32_t index)
+{
+    m_stamps.Remove(index);
+}
+
+/**
+ * @brief Only the head packet carries the current stamp.
+ */
+uint32_t
+VirtualClockQueue::GetBurstBytes(uint32_t index) const
+{
+    return m_headSizes[index];
+}
+
+/**
+ * @brief A still backlogged class files its next head packet.
+ */
+void
+VirtualClockQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    if (m_backlogs[index] > 0)
+    {
+        StampHead(index);
+    }
+}
+
+/**
+ * @brief A class's packets are stamped in arrival order, so stamping each packet once it
+ *        reaches the head, from its enqueue time, gives the stamp it would have got on arrival.
+ */
+void
+VirtualClockQueue::StampHead(uint32_t index)
+{
+    double arrival = GetTrafficClasses()[index]->GetHeadEnqueueTime().GetNanoSeconds();
+    m_clock[index] = std::max(arrival, m_clock[index]) + m_headSizes[index] / m_rates[index];
+    m_stamps.Push(index, m_clock[index]);
+}
+
+} // namespace ns3
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef VIRTUAL_CLOCK_QUEUE_H
+#define VIRTUAL_CLOCK_QUEUE_H
+
+#include "calendar-queue.h"
+#include "diff-serv.h"
+
+namespace ns3
+{
+
+/**
+ * @brief A DiffServ-based class implementing the Virtual Clock scheduler.
+ *
+ * Each class reserves a rate, and each packet is stamped with the time it would finish if its
+ * class were sent at exactly that rate from its arrival on: the later of its arrival and the
+ * previous stamp of its class, plus its size over the rate. Packets are served in stamp order.
+ * Unlike the fair queueing schedulers the stamps are real times, not virtual ones, so a class
+ * that sent above its rate while the link was idle is not given its reservation back later.
+ *
+ * The stamp of every backlogged class's head packet is kept in a calendar queue, so each packet
+ * costs O(1) as long as the stamps mostly lie within the span of its wheel.
+ */
+class VirtualClockQueue : public DiffServ
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Default constructor for VirtualClockQueue.
+     */
+    VirtualClockQueue();
+
+    /**
+     * @brief Schedule the next packet to dequeue using Virtual Clock.
+     *
+     * @return The next scheduled packet, or nullptr if no packets are available.
+     */
+    Ptr<Packet> Schedule() override;
+
+    /**
+     * @brief Classify a packet into one of the traffic classes.
+     *
+     * @param p The packet to classify.
+     * @return Index of the matching traffic class, or -1 if none match.
+     */
+    int32_t Classify(Ptr<Packet> p) override;
+
+    /**
+     * @brief Add a traffic class and reset the clocks.
+     *
+     * @param trafficClass Pointer to the TrafficClass to add.
+     */
+    void AddTrafficClass(Ptr<TrafficClass> trafficClass) override;
+
+  protected:
+    /**
+     * @brief Initialize the Virtual Clock queue from its JSON configuration.
+     */
+    void DoInitialize() override;
+
+    /**
+     * @brief Stamp the head packet of a class that just became backlogged.
+     *
+     * @param index Index of the class that received a packet.
+     */
+    void NotifyEnqueue(uint32_t index) override;
+
+    /**
+     * @brief Take an emptied class out of the calendar queue.
+     *
+     * @param index Index of the class that became empty.
+     */
+    void NotifyDrained(uint32_t index) override;
+
+    /**
+     * @brief A decision covers a single packet, so that every packet gets its own stamp.
+     *
+     * @param index Index of the selected class.
+     * @return The head packet size of the class.
+     */
+    uint32_t GetBurstBytes(uint32_t index) const override;
+
+    /**
+     * @brief Stamp the next head packet of the class that was served.
+     *
+     * @param index Index of the class that was served.
+     * @param bytes Bytes sent.
+     */
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    /**
+     * @brief Get the backlogged class whose head packet has the earliest stamp.
+     *
+     * @return Index of the selected class, or -1 if all queues are empty or shaped.
+     */
+    int32_t GetQueueForSchedule() const override;
+
+  private:
+    /**
+     * @brief Advance the clock of a class over its head packet and file the class under it.
+     *
+     * @param index Index of a backlogged class.
+     */
+    void StampHead(uint32_t index);
+
+    std::string m_configFile; // <- come from SetAttribute
+
+    Time m_slotWidth;            //!< Stamp range of one calendar queue bucket
+    std::vector<double> m_rates; //!< Reserved rate of each class in bytes per ns
+    std::vector<double> m_clock; //!< Stamp of the last packet stamped in each class, in ns
+    CalendarQueue m_stamps;      //!< Backlogged classes keyed by their head stamp
+};
+
+} // namespace ns3
+
+#endif // VIRTUAL_CLOCK_QUEUE_H
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#include "wf2q-queue.h"
+
+#include "qos-initializer.h"
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("Wf2qQueue");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(Wf2qQueue);
+
+// TypeId registration with ns-3
+TypeId
+Wf2qQueue::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::Wf2qQueue<Packet>")
+                            .SetParent<DiffServ>()
+                            .SetGroupName("Network")
+                            .AddConstructor<Wf2qQueue>()
+                            .AddAttribute("Config",
+                                          "Path to WF2Q+ configuration file",
+                                          StringValue(""),
+                                          MakeStringAccessor(&Wf2qQueue::m_configFile),
+                                          MakeStringChecker());
+    return tid;
+}
+
+Wf2qQueue::Wf2qQueue()
+    : m_virtualTime(0),
+      m_totalWeight(0)
+{
+}
+
+/**
+ * @brief Initializes the WF2Q+ queue using a JSON config file in the DRR format.
+ */
+void
+Wf2qQueue::DoInitialize()
+{
+    DiffServ::DoInitialize();
+    QosInitializer::InitializeWf2qFromJson(this, m_configFile);
+}
+
+/**
+ * @brief Classify incoming packets based on filters in TrafficClass.
+ */
+int32_t
+Wf2qQueue::Classify(Ptr<Packet> p)
+{
+    return ClassifyByFilters(p);
+}
+
+/**
+ * @brief Add a traffic class. Virtual times restart from zero for the new set of classes.
+ */
+void
+Wf2qQueue::AddTrafficClass(Ptr<TrafficClass> trafficClass)
+{
+    DiffServ::AddTrafficClass(trafficClass);
+
+    uint32_t n = m_weights.size();
+    m_virtualTime = 0;
+    m_totalWeight = 0;
+    for (uint32_t weight : m_weights)
+    {
+        m_totalWeight += weight;
+    }
+    m_start.assign(n, 0);
+    m_finish.assign(n, 0);
+    m_eligible.Reset(n);
+    m_waiting.Reset(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (m_backlogs[i] > 0)
+            NotifyEnqueue(i);
+    }
+}
+
+/**
+ * @brief Schedules the next packet for transmission using WF2Q+.
+ * @return A pointer to the packet to be dequeued, or nullptr if all queues are empty.
+ */
+Ptr<Packet>
+Wf2qQueue::Schedule()
+{
+    return ServeSelection();
+}
+
+/**
+ * @brief Pick the top of the eligible heap. Token buckets are outside the fair queueing model,
+ *        so if that class is out of tokens the heaps are scanned for the eligible class with the
+ *        smallest finish time that may send, then for the waiting class with the smallest start
+ *        time. The scan only happens while shaping holds a class back.
+ */
+int32_t
+Wf2qQueue::GetQueueForSchedule() const
+{
+    int32_t top = m_eligible.Top();
+    if (top >= 0 && IsEligible(top))
+    {
+        return top;
+    }
+
+    int32_t selected = -1;
+    for (uint32_t position = 0; position < m_eligible.GetSize(); ++position)
+    {
+        uint32_t i = m_eligible.GetAt(position);
+        if (IsEligible(i) && (selected < 0 || m_finish[i] < m_finish[selected]))
+            selected = i;
+    }
+    if (selected >= 0)
+    {
+        return selected;
+    }
+
+    for (uint32_t position = 0; position < m_waiting.GetSize(); ++position)
+    {
+        uint32_t i = m_waiting.GetAt(position);
+        if (IsEligible(i) && (selected < 0 || m_start[i] < m_start[selected]))
+            selected = i;
+    }
+    return selected;
+}
+
+/**
+ * @brief A class that becomes backlogged starts at the later of the virtual time and the finish
+ *        time of its previous packet.
+ */
+void
+Wf2qQueue::NotifyEnqueue(uint32_t index)
+{
+    if (m_eligible.Contains(index) || m_waiting.Contains(index))
+    {
+        return;
+    }
+
+    m_start[index] = std::max(m_virtualTime, m_finish[index]);
+    m_finish[index] = m_start[index] + double(m_headSizes[index]) / m_weights[index];
+    InsertClass(index);
+    UpdateVirtualTime();
+}
+
+/**
+ * @brief Remove an emptied class from the heaps.
+ */
+void
+Wf2qQueue::NotifyDrained(uint32_t index)
+{
+    m_eligible.Remove(index);
+    m_waiting.Remove(index);
+}
+
+/**
+ * @brief Only the head packet is covered by the current finish time.
+ */
+uint32_t
+Wf2qQueue::GetBurstBytes(uint32_t index) const
+{
+    return m_headSizes[index];
+}
+
+/**
+ * @brief The virtual time advances by the bytes sent over the total weight. If the class is
+ *        still backlogged, its next packet starts where the one just sent finished.
+ */
+void
+Wf2qQueue::ChargeClass(uint32_t index, uint32_t bytes)
+{
+    m_virtualTime += bytes / m_totalWeight;
+
+    // A drained class is charged before NotifyDrained, so it leaves the heaps here already
+    m_eligible.Remove(index);
+    m_waiting.Remove(index);
+    if (m_backlogs[index] > 0)
+    {
+        m_start[index] = m_finish[index];
+        m_finish[index] = m_start[index] + double(m_headSizes[index]) / m_weights[index];
+        InsertClass(index);
+    }
+    UpdateVirtualTime();
+}
+
+/**
+ * @brief Key a class by finish time if it may start now, by start time otherwise.
+ */
+void
+Wf2qQueue::InsertClass(uint32_t index)
+{
+    if (m_start[index] <= m_virtualTime)
+    {
+        m_eligible.Push(index, m_finish[index]);
+    }
+    else
+    {
+        m_waiting.Push(index, m_start[index]);
+    }
+}
+
+/**
+ * @brief WF2Q+ virtual time: V = max(V, min start time over backlogged classes). Since eligible
+ *        classes start no later than V, only an empty eligible heap can move V forward here.
+ */
+void
+Wf2qQueue::UpdateVirtualTime()
+{
+    if (m_eligible.GetSize() == 0 && m_waiting.GetSize() > 0)
+    {
+        m_virtualTime = std::max(m_virtualTime, m_waiting.TopKey());
+    }
+
+    while (m_waiting.GetSize() > 0 && m_waiting.TopKey() <= m_virtualTime)
+    {
+        uint32_t index = m_waiting.Top();
+        m_waiting.Remove(index);
+        m_eligible.Push(index, m_finish[index]);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) YEAR COPYRIGHTHOLDER
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Kexin Dai <kdai3@dons.usfca.edu>, Tiansi Gu <tgu10@dons.usfca.edu>
+ */
+
+#ifndef WF2Q_QUEUE_H
+#define WF2Q_QUEUE_H
+
+#include "diff-serv.h"
+#include "indexed-heap.h"
+
+namespace ns3
+{
+
+/**
+ * @brief A DiffServ-based class implementing Worst-case Fair Weighted Fair Queueing (WF2Q+).
+ *
+ * Each backlogged class carries the virtual start and finish time of its head packet, with the
+ * class weight as its share of the link. Among the classes whose start time has been reached
+ * by the system virtual time, the one with the smallest finish time is served. Eligible
+ * classes sit in a heap ordered by finish time and the others in a heap ordered by start time,
+ * so each packet costs O(log n).
+ */
+class Wf2qQueue : public DiffServ
+{
+  public:
+    /**
+     * @brief Register this class with the ns-3 type system.
+     *
+     * @return The TypeId associated with this class.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Default constructor for Wf2qQueue.
+     */
+    Wf2qQueue();
+
+    /**
+     * @brief Schedule the next packet to dequeue using WF2Q+.
+     *
+     * @return The next scheduled packet, or nullptr if no packets are available.
+     */
+    Ptr<Packet> Schedule() override;
+
+    /**
+     * @brief Classify a packet into one of the traffic classes.
+     *
+     * @param p The packet to classify.
+     * @return Index of the matching traffic class, or -1 if none match.
+     */
+    int32_t Classify(Ptr<Packet> p) override;
+
+    /**
+     * @brief Add a traffic class and reset the virtual times.
+     *
+     * @param trafficClass Pointer to the TrafficClass to add.
+     */
+    void AddTrafficClass(Ptr<TrafficClass> trafficClass) override;
+
+  protected:
+    /**
+     * @brief Initialize the WF2Q+ queue from its JSON configuration.
+     */
+    void DoInitialize() override;
+
+    /**
+     * @brief Stamp the head packet of a class that just became backlogged.
+     *
+     * @param index Index of the class that received a packet.
+     */
+    void NotifyEnqueue(uint32_t index) override;
+
+    /**
+     * @brief Take an emptied class out of the heaps; its finish time is kept.
+     *
+     * @param index Index of the class that became empty.
+     */
+    void NotifyDrained(uint32_t index) override;
+
+    /**
+     * @brief A decision covers a single packet, so that finish times stay exact.
+     *
+     * @param index Index of the selected class.
+     * @return The head packet size of the class.
+     */
+    uint32_t GetBurstBytes(uint32_t index) const override;
+
+    /**
+     * @brief Advance the system virtual time and stamp the next head packet of the class.
+     *
+     * @param index Index of the class that was served.
+     * @param bytes Bytes sent.
+     */
+    void ChargeClass(uint32_t index, uint32_t bytes) override;
+
+    /**
+     * @brief Get the eligible class with the smallest virtual finish time.
+     *
+     * @return Index of the selected class, or -1 if all queues are empty or shaped.
+     */
+    int32_t GetQueueForSchedule() const override;
+
+  private:
+    /**
+     * @brief Put a backlogged class in the eligible or the waiting heap, by its start time.
+     *
+     * @param index Index of the class.
+     */
+    void InsertClass(uint32_t index);
+
+    /**
+     * @brief Keep the virtual time at least the smallest start time, and move classes whose
+     *        start time has been reached to the eligible heap.
+     */
+    void UpdateVirtualTime();
+
+    std::string m_configFile; // <- come from SetAttribute
+
+    double m_virtualTime;         //!< System virtual time, in bytes per unit of total weight
+    double m_totalWeight;         //!< Sum of the weights of all classes
+    std::vector<double> m_start;  //!< Virtual start time of the head packet of each class
+    std::vector<double> m_finish; //!< Virtual finish time of the head (or last) packet
+    IndexedHeap m_eligible;       //!< Classes with start <= virtual time, keyed by finish time
+    IndexedHeap m_waiting;        //!< Classes with start > virtual time, keyed by start time
+};
+
+} // namespace ns3
+
+#endif // WF2Q_QUEUE_H